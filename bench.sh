@@ -0,0 +1,58 @@
+#!/bin/sh
+#
+# bench.sh
+#
+# Times loading, simulation and output of every scheduling algorithm
+# and memory allocator over generated traces of 10^3 up to 10^max
+# processes, printing one CSV row for each run. Runs taking longer
+# than the timeout are reported as such and larger traces skipped
+# for that combination. Written for project 2 of COMP30023 Computer
+# Systems, semester 1 2020.
+#
+# Usage: ./bench.sh [max] [timeout] [tracegen options...]
+#
+# Author: Brodie Daff
+#         bdaff@student.unimelb.edu.au
+
+MAX=${1:-5}
+TIMEOUT=${2:-20}
+[ $# -gt 0 ] && shift
+[ $# -gt 0 ] && shift
+
+SCHEDULERS="ff rr cs mlfq srtf cfs ma"
+ALLOCATORS="u p v cm d"
+MEM=400
+
+TRACE=$(mktemp)
+SLOW=""
+trap 'rm -f "$TRACE"' EXIT
+
+echo "processes,scheduler,allocator,load,simulation,output,total"
+
+n=1000
+e=3
+while [ $e -le "$MAX" ]; do
+
+    ./tracegen -n $n -r 0.05 "$@" > "$TRACE"
+
+    for a in $SCHEDULERS; do
+        for m in $ALLOCATORS; do
+
+            # Skip combinations that already timed out on a smaller trace
+            case "$SLOW" in *" $a/$m "*) echo "$n,$a,$m,,,,timeout"; continue;; esac
+
+            times=$(timeout "$TIMEOUT" ./scheduler -f "$TRACE" -a $a -m $m -s $MEM -x 2>&1 >/dev/null |
+                    sed -n 's/^CPU time \([0-9.]*\) seconds (load \([0-9.]*\), simulation \([0-9.]*\), output \([0-9.]*\))$/\2,\3,\4,\1/p')
+
+            if [ -z "$times" ]; then
+                SLOW="$SLOW $a/$m "
+                echo "$n,$a,$m,,,,timeout"
+            else
+                echo "$n,$a,$m,$times"
+            fi
+        done
+    done
+
+    n=$((n * 10))
+    e=$((e + 1))
+done
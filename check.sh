@@ -0,0 +1,183 @@
+#!/bin/sh
+#
+# check.sh
+#
+# Runs every scheduling algorithm and memory allocator over the
+# benchmark traces and the seeded traces in golden/traces, along with
+# the page replacement policies and the options that change how the
+# OS runs, checking each run against its golden output in golden/ and
+# its CPU time against the baseline in golden/baseline.csv. Runs over
+# the benchmark traces are checked line by line with -V. The seeded
+# traces give too much output to keep, so their statistics are kept
+# with a checksum of their events instead. With -u the golden outputs
+# and baseline are recorded from this build. Written for project 2 of
+# COMP30023 Computer Systems, semester 1 2020.
+#
+# The seeded traces were written by
+#     ./tracegen -n 2000 -S 1 > golden/traces/large.txt
+#     ./tracegen -n 500 -D 4 -S 1 > golden/traces/deps.txt
+#     ./tracegen -n 500 -I 20 -S 1 > golden/traces/io.txt
+#
+# Usage: ./check.sh [-u]
+#
+# Author: Brodie Daff
+#         bdaff@student.unimelb.edu.au
+
+SCHEDULERS="ff rr cs mlfq srtf cfs ma"
+ALLOCATORS="u p v cm d"
+MEM=200
+TIMEOUT=20
+ATTEMPTS=5
+
+GOLDEN=golden
+TRACES=$GOLDEN/traces
+BASELINE=$GOLDEN/baseline.csv
+
+UPDATE=0
+[ "$1" = "-u" ] && UPDATE=1
+
+OUT=$(mktemp)
+ERR=$(mktemp)
+NEW=$(mktemp)
+RUNS=$(mktemp)
+trap 'rm -f "$OUT" "$OUT.summary" "$ERR" "$NEW" "$RUNS"' EXIT
+
+# Name, trace and options of every run, one per line
+runs() {
+
+    for f in benchmark-cm benchmark-cs $TRACES/large; do
+        for a in $SCHEDULERS; do
+            for m in $ALLOCATORS; do
+                echo "${f##*/}-$a-$m $f.txt -a $a -m $m -s $MEM"
+            done
+        done
+    done
+
+    # Page replacement policies other than LRU
+    for p in clock sc lruk arc; do
+        for a in ff rr cfs; do
+            echo "large-$a-$p $TRACES/large.txt -a $a -m $p -s $MEM"
+        done
+    done
+
+    # Batched Round-Robin
+    for m in u v; do
+        echo "large-rr-$m-batch $TRACES/large.txt -a rr -m $m -s $MEM -B"
+    done
+
+    # Asynchronous backing store, with prefetching
+    for a in ff rr mlfq; do
+        for m in p v cm; do
+            echo "large-$a-$m-store $TRACES/large.txt -a $a -m $m -s $MEM -i 1"
+            echo "large-$a-$m-prefetch $TRACES/large.txt -a $a -m $m -s $MEM -i 2 -P"
+        done
+    done
+
+    # Fragmentation, with compaction
+    for m in p v; do
+        echo "large-cs-$m-frag $TRACES/large.txt -a cs -m $m -s $MEM -F"
+        echo "large-cs-$m-compact $TRACES/large.txt -a cs -m $m -s $MEM -F -c 1"
+    done
+
+    # Admission control
+    for a in ff rr cs; do
+        echo "large-$a-p-admit $TRACES/large.txt -a $a -m p -s $MEM -R 2"
+        echo "large-$a-v-admit $TRACES/large.txt -a $a -m v -s $MEM -R 1"
+    done
+
+    # Dependencies
+    for a in ff cs cp rr; do
+        for m in u v; do
+            echo "deps-$a-$m $TRACES/deps.txt -a $a -m $m -s $MEM"
+        done
+    done
+
+    # CPU and I/O bursts, with blocked processes evicted
+    for a in $SCHEDULERS; do
+        echo "io-$a-u $TRACES/io.txt -a $a -m u"
+        echo "io-$a-v $TRACES/io.txt -a $a -m v -s $MEM"
+    done
+    for a in rr mlfq; do
+        echo "io-$a-v-evict $TRACES/io.txt -a $a -m v -s $MEM -e"
+    done
+}
+
+# Statistics of a run and a checksum of its events
+summarise() {
+    grep -v '^[0-9]*, ' "$1"
+    echo "Events $(grep '^[0-9]*, ' "$1" | cksum)"
+}
+
+mkdir -p $GOLDEN
+echo "run,seconds" > "$NEW"
+
+passed=0
+failed=0
+
+runs > "$RUNS"
+
+while read -r name trace options; do
+
+    golden=$GOLDEN/$name.txt
+    baseline=$(grep "^$name," "$BASELINE" 2>/dev/null | cut -d, -f2)
+
+    # Seeded traces have only their summary compared
+    seeded=0
+    [ "${trace#$TRACES/}" != "$trace" ] && seeded=1
+
+    # CPU time is noisy, so baselines are the fastest of several runs and
+    # a run is only repeated when it fails for being slower than its baseline
+    seconds=
+    attempt=1
+    while [ $attempt -le $ATTEMPTS ]; do
+        if [ $UPDATE -eq 1 ]; then
+            timeout $TIMEOUT ./scheduler -f $trace $options -x < /dev/null > "$OUT" 2> "$ERR"
+        elif [ $seeded -eq 1 ]; then
+            timeout $TIMEOUT ./scheduler -f $trace $options -x -T "${baseline:-0}" < /dev/null > "$OUT" 2> "$ERR"
+        else
+            timeout $TIMEOUT ./scheduler -f $trace $options -V "$golden" -T "${baseline:-0}" < /dev/null > "$OUT" 2> "$ERR"
+        fi
+        result=$?
+
+        time=$(sed -n 's/^CPU time \([0-9.]*\) seconds.*$/\1/p' "$ERR")
+        if [ -z "$seconds" ] || awk "BEGIN { exit !(${time:-0} < $seconds) }"; then
+            seconds=$time
+        fi
+
+        if [ $UPDATE -eq 0 ]; then
+            grep -q "slower than allowed" "$ERR" || break
+            # Give whatever else was running a moment to finish
+            sleep 1
+        fi
+        attempt=$((attempt + 1))
+    done
+
+    if [ $seeded -eq 1 ]; then
+        summarise "$OUT" > "$OUT.summary"
+        if [ $UPDATE -eq 1 ]; then
+            cp "$OUT.summary" "$golden"
+        elif ! diff "$golden" "$OUT.summary" >> "$ERR" 2>&1; then
+            result=1
+        fi
+    elif [ $UPDATE -eq 1 ]; then
+        cp "$OUT" "$golden"
+    fi
+
+    # Runs too short to measure are given the smallest baseline that still counts
+    [ "$seconds" = "0.000" ] && seconds=0.001
+    echo "$name,$seconds" >> "$NEW"
+
+    if [ $result -eq 0 ]; then
+        passed=$((passed + 1))
+    else
+        failed=$((failed + 1))
+        echo "FAIL $name: ./scheduler -f $trace $options"
+        sed 's/^/    /' "$ERR"
+    fi
+done < "$RUNS"
+
+[ $UPDATE -eq 1 ] && cp "$NEW" "$BASELINE"
+
+echo "$passed passed, $failed failed"
+
+[ $failed -eq 0 ]
@@ -0,0 +1,73 @@
+/*
+ * arena.c
+ *
+ * A region allocator that hands out zeroed memory from large
+ * chunks and frees everything it handed out at once, for the many
+ * small allocations that live as long as the OS. Written for
+ * project 2 of COMP30023 Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Alignment of every allocation
+#define ARENA_ALIGN 16
+
+/*
+ * A chunk of memory in an arena.
+ *
+ * Chunk *next:  Chunk allocated before this one.
+ * size_t size:  Bytes of data in the chunk.
+ * size_t used:  Bytes of data handed out.
+ * char *data:   Memory handed out.
+ */
+typedef struct Chunk {
+    struct Chunk *next;
+    size_t size, used;
+    char *data;
+} Chunk;
+
+/*
+ * An arena of chunks, the newest first.
+ *
+ * Chunk *head:  Chunk allocations are taken from.
+ * size_t chunk: Smallest size of a new chunk.
+ */
+typedef struct Arena {
+    Chunk *head;
+    size_t chunk;
+} Arena;
+
+/*
+ * Creates an empty arena.
+ *
+ * size_t chunk: Smallest size of each chunk, ideally the total needed.
+ *
+ * Returns Arena*: Pointer to the new arena.
+ */
+Arena *arena_init(size_t chunk);
+
+/*
+ * Allocates zeroed memory from an arena, which stays allocated
+ * until the arena is freed.
+ *
+ * Arena *a:    Pointer to an arena.
+ * size_t size: Number of bytes wanted.
+ *
+ * Returns void*: Pointer to the memory.
+ */
+void *arena_alloc(Arena *a, size_t size);
+
+/*
+ * Frees an arena and everything allocated from it.
+ *
+ * Arena *a: Pointer to an arena, or NULL.
+ */
+void arena_free(Arena *a);
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * burst.c
+ *
+ * Processes that alternate between CPU and I/O bursts, given as
+ * bursts=cpu,io,cpu,... in a trace. A process blocks at the end
+ * of each CPU burst that is followed by an I/O burst, waiting in
+ * order of wake time while other processes run, and is handed back
+ * to the scheduling algorithm once its I/O completes. Written for
+ * project 2 of COMP30023 Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef BURST_H
+#define BURST_H
+
+#include "sys.h"
+
+/*
+ * Reads the CPU and I/O bursts of a process, given as a comma
+ * separated list starting with a CPU burst. The job time of the
+ * process is unchanged, so its last CPU burst runs for whatever
+ * is left of it.
+ *
+ * Process *p:  Pointer to a process.
+ * char *value: Lengths of its bursts.
+ */
+void burst_parse(Process *p, char *value);
+
+/*
+ * Frees the bursts read for each process.
+ *
+ * Process *p: Array of processes.
+ * int n:      Number of processes.
+ */
+void burst_free_lists(Process *p, int n);
+
+/*
+ * Sets up the queue of blocked processes of an OS, holding any
+ * that were blocked when it was checkpointed.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void burst_init(System *sys);
+
+/*
+ * Frees the queue of blocked processes of an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void burst_free(System *sys);
+
+/*
+ * Finds how long the process in the current context can run for
+ * before it blocks for I/O.
+ *
+ * System *sys:  Pointer to an OS struct.
+ * Time runtime: Longest time it would otherwise run for.
+ *
+ * Returns Time: The time given, or the time left in its CPU burst
+ *               if that is shorter.
+ */
+Time burst_limit(System *sys, Time runtime);
+
+/*
+ * Blocks the process in the current context, which has just been
+ * paused at the end of a CPU burst, until its I/O burst completes.
+ * Its pages are evicted if blocked processes are not kept resident.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void burst_block(System *sys);
+
+/*
+ * Hands every blocked process whose I/O has completed back to the
+ * scheduling algorithm.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void burst_wake(System *sys);
+
+/*
+ * Finds when the next blocked process wakes.
+ *
+ * System *sys: Pointer to an OS struct.
+ *
+ * Returns Time: Wake time of the next process, or UNDEF if none
+ *               are blocked.
+ */
+Time burst_next(System *sys);
+
+/*
+ * qsort comparison function for process wake time.
+ */
+int compare_wake(const void *a, const void *b);
+
+#endif
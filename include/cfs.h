@@ -0,0 +1,55 @@
+/*
+ * cfs.c
+ * 
+ * A Completely-Fair-Scheduler style process scheduling algorithm
+ * to run for a process scheduling simulator. Written for project
+ * 2 of COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef CFS_H
+#define CFS_H
+
+#include "sys.h"
+
+// Weight of a process with default priority
+#define CFS_WEIGHT 1024
+
+#ifndef CFS_GRANULARITY
+#define CFS_GRANULARITY 2
+#endif
+
+/*
+ * Allocates the tree of processes ordered by virtual runtime.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void cfs_init(System *sys);
+
+/*
+ * Frees the tree of processes ordered by virtual runtime.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void cfs_free(System *sys);
+
+/*
+ * Receives a newly arrived process, starting it at the smallest
+ * virtual runtime of the processes already received.
+ * 
+ * System *sys: Pointer to the OS.
+ * int i:       Index in the process table of the new process.
+ */
+void cfs_admit(System *sys, int i);
+
+/*
+ * Handles a clock cycle for the OS according to
+ * Completely-Fair-Scheduler scheduling.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void cfs_step(System *sys);
+
+#endif
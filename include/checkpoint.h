@@ -0,0 +1,84 @@
+/*
+ * checkpoint.c
+ * 
+ * Saving the full state of a running OS to a file, and restoring
+ * it to continue running, possibly with different algorithms.
+ * Written for project 2 of COMP30023 Computer Systems, semester 1
+ * 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "sys.h"
+
+// Identifies checkpoint files and their layout
+#define CHECKPOINT_MAGIC "SCHEDCP1"
+
+/*
+ * State read from a checkpoint that is held until the OS has set
+ * up its algorithms, which may differ from those checkpointed.
+ * 
+ * Scheduler scheduler: Process scheduling algorithm checkpointed.
+ * Allocator allocator: Memory allocation algorithm checkpointed.
+ * Policy policy:       Page replacement policy checkpointed.
+ * Time boosted:        Time of the most recent priority boost.
+ * long long min_vruntime: Smallest virtual runtime of any received process.
+ * int weight_total:    Total weight of all received processes.
+ * int *order:          Ready processes in the order they were queued (if applicable).
+ * int n_order:         Number of queued ready processes.
+ * Replacer *replacer:  Page replacement state (if demand paging).
+ * Store *store:        Backing store state (if applicable).
+ * int *io:             Processes waiting on the backing store in order.
+ * int n_io:            Number of processes waiting on the backing store.
+ * Frag *frag:          Fragmentation statistics (if applicable).
+ * Stats *stats:        Statistics of processes finished.
+ */
+typedef struct Snapshot {
+    Scheduler scheduler;
+    Allocator allocator;
+    Policy policy;
+    Time boosted;
+    long long min_vruntime;
+    int weight_total;
+    int *order, n_order;
+    struct Replacer *replacer;
+    struct Store *store;
+    int *io, n_io;
+    struct Frag *frag;
+    struct Stats *stats;
+} Snapshot;
+
+/*
+ * Writes the full state of an OS to a file. Must only be called
+ * between clock cycles, once evictions have been reported.
+ * 
+ * System *sys:    Pointer to an OS struct.
+ * char *filename: File to write to.
+ */
+void checkpoint(System *sys, char *filename);
+
+/*
+ * Reads the state of an OS from a checkpoint file. Algorithms and
+ * settings may be changed before it is run, which continues from
+ * where the checkpoint was made.
+ * 
+ * char *filename: File to read from.
+ * Process **p:    Set to the array of Processes for the process table.
+ * 
+ * Returns System*: Pointer to the restored OS struct.
+ */
+System *restore(char *filename, Process **p);
+
+/*
+ * Fills the data structures of algorithms that have just been set
+ * up for a restored OS with the checkpointed state.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void restore_state(System *sys);
+
+#endif
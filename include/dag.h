@@ -0,0 +1,93 @@
+/*
+ * dag.c
+ *
+ * Dependencies between processes, where a process given after=id,...
+ * is held back from arriving until each of those processes has
+ * finished, and a critical path first scheduling algorithm that
+ * runs the process with the longest chain of work waiting on it.
+ * Written for project 2 of COMP30023 Computer Systems, semester 1
+ * 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef DAG_H
+#define DAG_H
+
+#include "sys.h"
+
+/*
+ * Dependencies between the processes of a process table, with the
+ * children of every process kept together in one array.
+ *
+ * int *start:    Index in children of the first child of each process,
+ *                with one more for the end of the last.
+ * int *children: Index in the process table of each child.
+ * int *blocked:  Number of parents of each process that have not finished.
+ */
+typedef struct Dag {
+    int *start, *children, *blocked;
+} Dag;
+
+/*
+ * Reads the IDs of the processes a process depends on, given as
+ * a comma separated list.
+ *
+ * Process *p:  Pointer to a process.
+ * char *value: IDs of its parents.
+ */
+void dag_parse(Process *p, char *value);
+
+/*
+ * Builds the dependencies between the processes of an OS, if any
+ * process has parents, and finds the critical path through each
+ * process unless it was restored from a checkpoint. Exits if the
+ * dependencies have a cycle.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void dag_init(System *sys);
+
+/*
+ * Frees the dependencies between the processes of an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void dag_free(System *sys);
+
+/*
+ * Frees the parents read for each process.
+ *
+ * Process *p: Array of processes.
+ * int n:      Number of processes.
+ */
+void dag_free_edges(Process *p, int n);
+
+/*
+ * Checks if a process is still waiting for a parent to finish.
+ *
+ * System *sys: Pointer to an OS struct.
+ * int i:       Index in the process table of the process.
+ *
+ * Returns int: True if it is blocked, false otherwise.
+ */
+int dag_blocked(System *sys, int i);
+
+/*
+ * Releases the children of a process that has just finished once
+ * none of their parents are left, receiving those that have already
+ * arrived. The others are received when they arrive.
+ *
+ * System *sys: Pointer to an OS struct.
+ * int i:       Index in the process table of the finished process.
+ */
+void dag_finish(System *sys, int i);
+
+/*
+ * qsort comparison function for the critical path through a process,
+ * longest first and then in order of arrival.
+ */
+int compare_critical(const void *a, const void *b);
+
+#endif
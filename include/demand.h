@@ -0,0 +1,56 @@
+/*
+ * demand.c
+ * 
+ * Demand paging for virtual memory, where pages are only loaded
+ * when a running process references them. Written for project 2
+ * of COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef DEMAND_H
+#define DEMAND_H
+
+#include "sys.h"
+
+// Page references made by a running process per unit of time
+#ifndef DEMAND_REFS
+#define DEMAND_REFS 1
+#endif
+
+/*
+ * Gives every process a page table, allocated together from one
+ * arena, pointing at any of its pages already in memory.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void demand_init(System *sys);
+
+/*
+ * Frees the page tables of every process at once.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void demand_free(System *sys);
+
+/*
+ * Prepares the process in the current context to run. No pages
+ * are loaded until they are referenced.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void demand(System *sys);
+
+/*
+ * Runs the process in the current context, generating page
+ * references from its access model and resolving page faults
+ * as they occur. Each fault stalls the process while the page
+ * is loaded.
+ * 
+ * System *sys:  Pointer to an OS struct.
+ * Time runtime: CPU time to run the process for.
+ */
+void demand_run(System *sys, Time runtime);
+
+#endif
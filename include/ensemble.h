@@ -0,0 +1,89 @@
+/*
+ * ensemble.c
+ *
+ * Monte Carlo ensembles of an OS, running replicas of it with
+ * randomly perturbed processes in parallel and reporting each
+ * statistic with a confidence interval. Written for project 2 of
+ * COMP30023 Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include <pthread.h>
+
+#include "sys.h"
+
+// Spread of job times when no noise is given
+#ifndef ENSEMBLE_JOB_NOISE
+#define ENSEMBLE_JOB_NOISE 0.1
+#endif
+
+// Random number streams of replicas start after those of processes
+#define ENSEMBLE_STREAM ((uint64_t)1 << 32)
+
+typedef enum metric {
+    THROUGHPUT_AVG, THROUGHPUT_MIN, THROUGHPUT_MAX, TURNAROUND, OVERHEAD_MAX, OVERHEAD_AVG,
+    MAKESPAN, FAULTS, IO_UTILISATION, N_METRICS
+} Metric;
+
+/*
+ * Random perturbation of each process in a replica.
+ *
+ * double job:   Spread of job times, as the standard deviation of their logarithm,
+ *               keeping their mean.
+ * double mem:   Spread of memory in the same way, rounded up to whole pages.
+ * Time arrival: Largest change to arrival times, either way.
+ */
+typedef struct Noise {
+    double job, mem;
+    Time arrival;
+} Noise;
+
+/*
+ * Replicas of an OS and the threads running them.
+ *
+ * System *base:      OS every replica copies, which is not run itself.
+ * Noise noise:       Perturbation of each process.
+ * double metrics:    Statistics printed for an OS, for each replica.
+ * int n:             Number of replicas.
+ * int next:          Next replica to be run by a thread.
+ * Sketch turnaround: Turnaround times in every replica.
+ * Sketch waiting:    Turnaround times less job times in every replica.
+ * Sketch overhead:   Time overheads in every replica, in hundredths.
+ * pthread_mutex_t lock: Lock on the next replica and the sketches.
+ */
+typedef struct Ensemble {
+    System *base;
+    Noise noise;
+    double (*metrics)[N_METRICS];
+    int n, next;
+    Sketch turnaround, waiting, overhead;
+    pthread_mutex_t lock;
+} Ensemble;
+
+/*
+ * Reads the noise of an ensemble given as job,mem,arrival, where
+ * missing values are left unchanged.
+ *
+ * Noise *noise: Pointer to the noise to set.
+ * char *spec:   Comma separated spreads and arrival jitter.
+ */
+void ensemble_noise(Noise *noise, char *spec);
+
+/*
+ * Runs replicas of an OS with perturbed processes, across threads,
+ * and prints the mean of each statistic with a 95% confidence
+ * interval. The OS itself is not run.
+ *
+ * System *sys:  Pointer to an OS struct that has not been run.
+ * int n:        Number of replicas.
+ * Noise noise:  Perturbation of each process.
+ * int threads:  Number of threads, or 0 for one per processor.
+ */
+void ensemble(System *sys, int n, Noise noise, int threads);
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * frag.c
+ * 
+ * Memory fragmentation metrics, tracked as pages are allocated
+ * and freed, and a compaction pass that relocates pages so every
+ * process is contiguous. Written for project 2 of COMP30023
+ * Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef FRAG_H
+#define FRAG_H
+
+#include "sys.h"
+
+// Free extents are counted by powers of two in size
+#define FRAG_BUCKETS 32
+
+/*
+ * Fragmentation state of memory. Each run of free pages holds its
+ * length at both its first and last page.
+ * 
+ * int *run:        Length of the free run each boundary page belongs to.
+ * int hist:        Number of free runs with a length in each bucket.
+ * int cost:        Time to relocate a page, or UNDEF to never compact.
+ * int dispatches:  Number of times memory was sampled.
+ * long long extents: Sum of extents of processes when dispatched.
+ * int extents_max: Most extents a process has been dispatched with.
+ * long long hist_total: Sum of each bucket of the histogram when sampled.
+ * int passes:      Number of compaction passes.
+ * int moved:       Number of pages relocated by compaction.
+ * Time time:       Total time spent compacting.
+ * int *rank:       Scratch order of each process when compacting.
+ * int *offset:     Scratch next address of each process when compacting.
+ * Page *packed:    Scratch memory when compacting.
+ */
+typedef struct Frag {
+    int *run;
+    int hist[FRAG_BUCKETS];
+    int cost, dispatches;
+    long long extents;
+    int extents_max;
+    long long hist_total[FRAG_BUCKETS];
+    int passes, moved;
+    Time time;
+    int *rank, *offset;
+    Page *packed;
+} Frag;
+
+/*
+ * Allocates fragmentation tracking for the memory of an OS.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void frag_init(System *sys);
+
+/*
+ * Frees the fragmentation tracking of an OS.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void frag_free(System *sys);
+
+/*
+ * Updates fragmentation after a free page has been allocated.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ */
+void frag_assign(System *sys, int addr);
+
+/*
+ * Updates fragmentation for a page about to be freed.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ */
+void frag_release(System *sys, int addr);
+
+/*
+ * Records the fragmentation of memory as the process in the
+ * current context is dispatched.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void frag_sample(System *sys);
+
+/*
+ * Relocates pages so that every process is contiguous and all free
+ * memory is one run at the end, if the process in the current
+ * context is not already contiguous. The time taken is added to
+ * the load time of the process.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void compact(System *sys);
+
+#endif
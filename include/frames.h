@@ -0,0 +1,121 @@
+/*
+ * frames.c
+ *
+ * A compact map of which process owns each memory page, kept
+ * alongside the pages so that scans over all of memory read 4
+ * bytes or 1 bit a page rather than a whole Page. Searches use
+ * vector instructions where the build has them. Written for
+ * project 2 of COMP30023 Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef FRAMES_H
+#define FRAMES_H
+
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "sys.h"
+
+// Owner slots compared at once, and the padding after the last page
+#if defined(__AVX2__)
+#define FRAMES_LANES 8
+#elif defined(__SSE2__)
+#define FRAMES_LANES 4
+#else
+#define FRAMES_LANES 1
+#endif
+#define FRAMES_PAD 8
+
+/*
+ * Owner of each memory page.
+ *
+ * int32_t *owner:     Index in the process table of the owner of each page, or
+ *                     UNDEF if free, followed by FRAMES_PAD free slots.
+ * uint64_t *occupied: Bitmap of allocated pages.
+ * int n:              Number of memory pages.
+ * int words:          Number of words in the bitmap.
+ */
+typedef struct Frames {
+    int32_t *owner;
+    uint64_t *occupied;
+    int n, words;
+} Frames;
+
+/*
+ * Builds the owner map for the memory of an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void frames_init(System *sys);
+
+/*
+ * Frees the owner map of an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void frames_free(System *sys);
+
+/*
+ * Rebuilds the owner map after pages were changed all at once.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void frames_rebuild(System *sys);
+
+/*
+ * Records that a page has been allocated.
+ *
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ * int pix:     Index in the process table of the process.
+ */
+void frames_assign(System *sys, int addr, int pix);
+
+/*
+ * Records that a page has been freed.
+ *
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ */
+void frames_release(System *sys, int addr);
+
+/*
+ * Finds the first free page at or after an address.
+ *
+ * Frames *f: Pointer to an owner map.
+ * int from:  Memory address to start from.
+ *
+ * Returns int: Memory address of the page, or UNDEF if there is none.
+ */
+int frames_next_free(Frames *f, int from);
+
+/*
+ * Finds the first allocated page at or after an address.
+ *
+ * Frames *f: Pointer to an owner map.
+ * int from:  Memory address to start from.
+ *
+ * Returns int: Memory address of the page, or UNDEF if there is none.
+ */
+int frames_next_used(Frames *f, int from);
+
+/*
+ * Finds the first page allocated to a process at or after an address.
+ *
+ * Frames *f: Pointer to an owner map.
+ * int pix:   Index in the process table of the process.
+ * int from:  Memory address to start from.
+ *
+ * Returns int: Memory address of the page, or UNDEF if there is none.
+ */
+int frames_next_owned(Frames *f, int pix, int from);
+
+#endif
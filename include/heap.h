@@ -0,0 +1,93 @@
+/*
+ * heap.c
+ * 
+ * An indexed binary min-heap of process table indices, ordered
+ * by a qsort style comparison of the processes, for use by the
+ * scheduling algorithms. Written for project 2 of COMP30023
+ * Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stddef.h>
+
+/*
+ * Binary min-heap of indices into an array of records.
+ * 
+ * int *items:     Heap ordered array of indices.
+ * int *pos:       Position of each index in items, or -1 if not in the heap.
+ * int n:          Number of indices in the heap.
+ * int size:       Number of records that may be indexed.
+ * void **base:    Pointer to the (possibly reallocated) array of records.
+ * size_t width:   Size in bytes of each record.
+ * int (*compare): qsort style comparison function for two records.
+ */
+typedef struct Heap {
+    int *items, *pos;
+    int n, size;
+    void **base;
+    size_t width;
+    int (*compare)(const void *, const void *);
+} Heap;
+
+/*
+ * Allocates memory for a new, empty heap.
+ * 
+ * void **base:    Pointer to the array of records that will be indexed.
+ * int size:       Number of records in the array.
+ * size_t width:   Size in bytes of each record.
+ * int (*compare): qsort style comparison function for two records.
+ * 
+ * Returns Heap*: Pointer to the new Heap struct.
+ */
+Heap *create_heap(void **base, int size, size_t width,
+                  int (*compare)(const void *, const void *));
+
+/*
+ * Frees a heap and its arrays.
+ * 
+ * Heap *h: Pointer to a heap.
+ */
+void free_heap(Heap *h);
+
+/*
+ * Adds a record index to a heap, growing it if the index is past
+ * the records it was made for.
+ * 
+ * Heap *h: Pointer to a heap.
+ * int i:   Index of the record to add.
+ */
+void heap_push(Heap *h, int i);
+
+/*
+ * Removes the index of the smallest record from a heap.
+ * 
+ * Heap *h: Pointer to a non-empty heap.
+ * 
+ * Returns int: Index of the smallest record.
+ */
+int heap_pop(Heap *h);
+
+/*
+ * Restores heap order after the key of a record has changed.
+ * Does nothing if the record is not in the heap.
+ * 
+ * Heap *h: Pointer to a heap.
+ * int i:   Index of the changed record.
+ */
+void heap_update(Heap *h, int i);
+
+/*
+ * Removes a record index from anywhere within a heap. Does
+ * nothing if the record is not in the heap.
+ * 
+ * Heap *h: Pointer to a heap.
+ * int i:   Index of the record to remove.
+ */
+void heap_remove(Heap *h, int i);
+
+#endif
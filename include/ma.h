@@ -0,0 +1,53 @@
+/*
+ * ma.c
+ * 
+ * A memory-aware process scheduling algorithm, which prefers to
+ * run processes with the most pages already in memory, to run for
+ * a process scheduling simulator. Written for project 2 of
+ * COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef MA_H
+#define MA_H
+
+#include "sys.h"
+
+#ifndef MA_AGING
+#define MA_AGING 50
+#endif
+
+/*
+ * Allocates the indices of received processes by missing
+ * pages and by time last run.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void ma_init(System *sys);
+
+/*
+ * Frees the indices of received processes.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void ma_free(System *sys);
+
+/*
+ * Receives a process ready to be run into both indices.
+ * 
+ * System *sys: Pointer to the OS.
+ * int i:       Index in the process table of the process.
+ */
+void ma_admit(System *sys, int i);
+
+/*
+ * Handles a clock cycle for the OS according to
+ * memory-aware scheduling.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void ma_step(System *sys);
+
+#endif
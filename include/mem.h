@@ -14,6 +14,12 @@
 
 #include "sys.h"
 
+/*
+ * Comparison function for qsort that compares time last allocated
+ * for processes.
+ */
+int compare_last(const void *a, const void *b);
+
 /*
  * Allocates memory for an array of Page structures
  * representing the memory in the scheduling simulator.
@@ -25,6 +31,24 @@
  */
 Page *create_memory(int size, int page_size);
 
+/*
+ * Allocates a free memory page to a process.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of a free page.
+ * int pix:     Index in the process table of the process.
+ */
+void page_assign(System *sys, int addr, int pix);
+
+/*
+ * Frees a memory page, removing it from the page table of
+ * the process it was allocated to.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of an allocated page.
+ */
+void page_release(System *sys, int addr);
+
 /*
  * Allocates pages to the process in the current context.
  * Only allocates pages that are free, does not create
@@ -39,10 +63,10 @@ void allocate(System *sys, int target);
  * Evicts pages currently allocated to a process.
  * 
  * System *sys: Pointer to an OS struct.
- * int pid:     Process ID to evict pages for.
+ * int pix:     Index in the process table of the process to evict pages for.
  * int n:       Number of pages to evict.
  */
-void evict_process(System *sys, int pid, int n);
+void evict_process(System *sys, int pix, int n);
 
 /*
  * Evicts pages from memory irregardless of which process they belong to.
@@ -53,6 +77,24 @@ void evict_process(System *sys, int pid, int n);
  */
 void evict_pages(System *sys, int *pages, int n);
 
+/*
+ * Notifies of evicted pages, or holds onto them to be reported
+ * together with any other evictions at the same time if batching.
+ * 
+ * System *sys:  Pointer to an OS struct.
+ * int *evicted: malloc'd array of evicted memory addresses.
+ * int n:        Number of evicted addresses.
+ */
+void report_evictions(System *sys, int *evicted, int n);
+
+/*
+ * Reports the pages evicted so far at the current time as a
+ * single eviction, if evictions are being batched.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void flush_evictions(System *sys);
+
 /*
  * Finds the least recently allocated process in the
  * process table.
@@ -73,6 +115,44 @@ int oldest(System sys);
  */
 void swap(System *sys);
 
+/*
+ * Sorts an array of pointers to processes by a comparison of the
+ * processes they point to.
+ * 
+ * Process **refs: Array of pointers to processes.
+ * int n:          Number of pointers.
+ * int (*compare): qsort style comparison function for two processes.
+ */
+void sort_processes(Process **refs, int n, int (*compare)(const void *, const void *));
+
+/*
+ * Lists the processes with pages in memory, ordered by a comparison
+ * of processes. Only pointers are sorted, not the processes.
+ * 
+ * System *sys:    Pointer to an OS struct.
+ * int (*compare): qsort style comparison function for two processes.
+ * int *n:         Set to the number of processes listed.
+ * 
+ * Returns Process**: malloc'd array of pointers into the process table.
+ */
+Process **resident(System *sys, int (*compare)(const void *, const void *), int *n);
+
+/*
+ * Finds pages to evict from processes other than the one in the
+ * current context, taking every page of each process in turn.
+ * 
+ * System *sys:      Pointer to an OS struct.
+ * Process **order:  Processes to take pages from, in order.
+ * int n_order:      Number of processes in the order.
+ * int *candidates:  Array of memory addresses found.
+ * int n_candidates: Number of memory addresses already found.
+ * int wanted:       Number of memory addresses wanted.
+ * 
+ * Returns int: Number of memory addresses found.
+ */
+int find_victims(System *sys, Process **order, int n_order, int *candidates, int n_candidates,
+                 int wanted);
+
 /*
  * Performs memory swaps based on the virtual memory algorithm.
  * Chooses the oldest allocated processes and evicts only the
@@ -83,4 +163,15 @@ void swap(System *sys);
  */
 void virtual(System *sys);
 
+/*
+ * Finds the page fault time added to the remaining time of the
+ * current context as it is dispatched, for the allocators that
+ * charge page faults that way.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * 
+ * Returns Time: Number of its pages left out of memory, or 0.
+ */
+Time fault_penalty(System *sys);
+
 #endif
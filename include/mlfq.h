@@ -0,0 +1,60 @@
+/*
+ * mlfq.c
+ * 
+ * A Multi-Level Feedback Queue process scheduling algorithm
+ * to run for a process scheduling simulator. Written for
+ * project 2 of COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef MLFQ_H
+#define MLFQ_H
+
+#include "sys.h"
+
+#ifndef MLFQ_LEVELS
+#define MLFQ_LEVELS 3
+#endif
+
+#ifndef MLFQ_BOOST
+#define MLFQ_BOOST 100
+#endif
+
+// Largest shift of an int quantum that still fits in a Time
+#ifndef MLFQ_MAX_SHIFT
+#define MLFQ_MAX_SHIFT 32
+#endif
+
+/*
+ * Allocates a queue for each priority level.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void mlfq_init(System *sys);
+
+/*
+ * Frees the priority level queues.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void mlfq_free(System *sys);
+
+/*
+ * Receives a newly arrived process into the highest priority level.
+ * 
+ * System *sys: Pointer to the OS.
+ * int i:       Index in the process table of the new process.
+ */
+void mlfq_admit(System *sys, int i);
+
+/*
+ * Handles a clock cycle for the OS according to
+ * Multi-Level Feedback Queue scheduling.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void mlfq_step(System *sys);
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * online.c
+ *
+ * Online running of an OS, reading processes from stdin or a Unix
+ * domain socket as they arrive rather than from a whole file. The
+ * clock is driven by the input, so the OS only runs up to the latest
+ * time every arrival is known for, and events are printed as they
+ * happen with the time taken to decide each recorded. Written for
+ * project 2 of COMP30023 Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef ONLINE_H
+#define ONLINE_H
+
+#include <stdio.h>
+#include <time.h>
+
+#include "sys.h"
+
+// Source read from stdin rather than a socket
+#define ONLINE_STDIN "-"
+
+/*
+ * Arrivals being read as an OS runs.
+ *
+ * FILE *in:           Stream processes are read from.
+ * int socket:         Flag for reading from a socket, whose stream is also written to.
+ * int size:           Number of processes the process table has room for.
+ * int eof:            Flag for the end of the input.
+ * Time horizon:       Latest time every arrival up to is known.
+ * struct timespec read: Wall clock time the latest line was read.
+ * Sketch *latency:    Nanoseconds from reading a line to each event it let happen.
+ * long long latency_max: Longest of those times.
+ */
+typedef struct Online {
+    FILE *in;
+    int socket, size, eof;
+    Time horizon;
+    struct timespec read;
+    struct Sketch *latency;
+    long long latency_max;
+} Online;
+
+/*
+ * Starts reading processes for an OS with an empty process table,
+ * from stdin or by waiting for a connection on a Unix domain socket,
+ * to which events are then also printed.
+ *
+ * System *sys:  Pointer to an OS struct that has not been run.
+ * char *source: ONLINE_STDIN, or the path of the socket to listen on.
+ */
+void online_init(System *sys, char *source);
+
+/*
+ * Stops reading processes for an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void online_free(System *sys);
+
+/*
+ * Reads processes until every arrival up to a time is known, or the
+ * input ends. Does nothing if the OS is not online.
+ *
+ * System *sys: Pointer to an OS struct.
+ * Time until:  Time arrivals must be known up to.
+ */
+void online_until(System *sys, Time until);
+
+/*
+ * Reads processes until one more is in the process table, or the
+ * input ends. Does nothing if the OS is not online.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void online_next(System *sys);
+
+/*
+ * Records the time taken to decide an event that has been printed,
+ * and sends it on.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void online_decided(System *sys);
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * pheap.c
+ * 
+ * A pairing heap of process table indices, ordered by a qsort
+ * style comparison of the processes, for use by the scheduling
+ * algorithms. Written for project 2 of COMP30023 Computer
+ * Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef PHEAP_H
+#define PHEAP_H
+
+#include <stddef.h>
+
+/*
+ * Pairing heap of indices into an array of records. Nodes are
+ * the record indices themselves, linked by their leftmost child
+ * and right sibling.
+ * 
+ * int root:       Index of the smallest record, or -1 if empty.
+ * int n:          Number of indices in the heap.
+ * int size:       Number of records that may be indexed.
+ * int *child:     Leftmost child of each node.
+ * int *next:      Right sibling of each node.
+ * int *pairs:     Scratch space for merging subtrees.
+ * void **base:    Pointer to the (possibly reallocated) array of records.
+ * size_t width:   Size in bytes of each record.
+ * int (*compare): qsort style comparison function for two records.
+ */
+typedef struct PHeap {
+    int root, n, size;
+    int *child, *next, *pairs;
+    void **base;
+    size_t width;
+    int (*compare)(const void *, const void *);
+} PHeap;
+
+/*
+ * Allocates memory for a new, empty pairing heap.
+ * 
+ * void **base:    Pointer to the array of records that will be indexed.
+ * int size:       Number of records in the array.
+ * size_t width:   Size in bytes of each record.
+ * int (*compare): qsort style comparison function for two records.
+ * 
+ * Returns PHeap*: Pointer to the new PHeap struct.
+ */
+PHeap *create_pheap(void **base, int size, size_t width,
+                    int (*compare)(const void *, const void *));
+
+/*
+ * Frees a pairing heap and its arrays.
+ * 
+ * PHeap *h: Pointer to a pairing heap.
+ */
+void free_pheap(PHeap *h);
+
+/*
+ * Adds a record index to a pairing heap in O(1).
+ * 
+ * PHeap *h: Pointer to a pairing heap.
+ * int i:    Index of the record to add.
+ */
+void pheap_push(PHeap *h, int i);
+
+/*
+ * Removes the index of the smallest record from a pairing heap
+ * in amortised O(log n).
+ * 
+ * PHeap *h: Pointer to a non-empty pairing heap.
+ * 
+ * Returns int: Index of the smallest record.
+ */
+int pheap_pop(PHeap *h);
+
+#endif
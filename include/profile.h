@@ -0,0 +1,112 @@
+/*
+ * profile.c
+ *
+ * Counters of the time spent in and the work done by each phase
+ * of the OS, compiled in only when built with PROFILE defined.
+ * Written for project 2 of COMP30023 Computer Systems, semester 1
+ * 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "sys.h"
+
+typedef enum phase { ADMISSION, CONTEXT, ALLOCATION, EVICTION, OUTPUT, N_PHASES } Phase;
+typedef enum counter { SCANNED, ALLOCATED, EVICTED, N_COUNTERS } Counter;
+
+/*
+ * Counters for each phase of the OS.
+ *
+ * uint64_t cycles:  Cycles spent in each phase, including phases within it.
+ * uint64_t calls:   Number of times each phase was entered.
+ * uint64_t counts:  Frames scanned, pages allocated and pages evicted.
+ */
+typedef struct Profile {
+    uint64_t cycles[N_PHASES], calls[N_PHASES];
+    uint64_t counts[N_COUNTERS];
+} Profile;
+
+/*
+ * Reads the cycle counter, or a nanosecond clock where there is none.
+ * Also used to time output when a run is timed with -x.
+ */
+static inline uint64_t profile_cycles(void) {
+
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+#endif
+}
+
+#ifdef PROFILE
+
+// Times a phase from its start to its stop within one block
+#define PROFILE_START(sys, phase) uint64_t _start_##phase = profile_cycles()
+#define PROFILE_STOP(sys, phase) do { \
+        if ((sys)->profile != NULL) { \
+            (sys)->profile->cycles[phase] += profile_cycles() - _start_##phase; \
+            (sys)->profile->calls[phase]++; \
+        } \
+    } while (0)
+#define PROFILE_COUNT(sys, counter, n) do { \
+        if ((sys)->profile != NULL) (sys)->profile->counts[counter] += (n); \
+    } while (0)
+
+#else
+
+#define PROFILE_START(sys, phase)
+#define PROFILE_STOP(sys, phase)
+#define PROFILE_COUNT(sys, counter, n)
+
+#endif
+
+/*
+ * Starts counting for an OS, if counters are compiled in.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void profile_init(System *sys);
+
+/*
+ * Prints the counters of an OS to stderr and frees them.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void profile_free(System *sys);
+
+/*
+ * Updates the current context using a scheduling algorithm's
+ * context function, timing it as context selection.
+ *
+ * System *sys:                     Pointer to an OS struct.
+ * Status (*context)(System *sys):  Context function of the algorithm.
+ *
+ * Returns Status: Status returned by the context function.
+ */
+static inline Status profile_context(System *sys, Status (*context)(System *sys)) {
+
+#ifdef PROFILE
+    PROFILE_START(sys, CONTEXT);
+    Status status = context(sys);
+    PROFILE_STOP(sys, CONTEXT);
+    return status;
+#else
+    return context(sys);
+#endif
+}
+
+#endif
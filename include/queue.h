@@ -0,0 +1,61 @@
+/*
+ * queue.c
+ * 
+ * A growable First-In-First-Out queue of process table indices
+ * for use by the scheduling algorithms. Written for project 2
+ * of COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef QUEUE_H
+#define QUEUE_H
+
+/*
+ * Ring buffer of integers.
+ * 
+ * int *items: Buffer of queued values.
+ * int head:   Index in the buffer of the front of the queue.
+ * int n:      Number of values in the queue.
+ * int size:   Capacity of the buffer.
+ */
+typedef struct Queue {
+    int *items;
+    int head, n, size;
+} Queue;
+
+/*
+ * Allocates memory for a new, empty queue.
+ * 
+ * int size: Initial capacity of the queue.
+ * 
+ * Returns Queue*: Pointer to the new Queue struct.
+ */
+Queue *create_queue(int size);
+
+/*
+ * Frees a queue and its buffer.
+ * 
+ * Queue *q: Pointer to a queue.
+ */
+void free_queue(Queue *q);
+
+/*
+ * Adds a value to the back of a queue, growing it if full.
+ * 
+ * Queue *q: Pointer to a queue.
+ * int v:    Value to add.
+ */
+void enqueue(Queue *q, int v);
+
+/*
+ * Removes the value at the front of a queue.
+ * 
+ * Queue *q: Pointer to a non-empty queue.
+ * 
+ * Returns int: The removed value.
+ */
+int dequeue(Queue *q);
+
+#endif
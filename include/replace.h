@@ -0,0 +1,126 @@
+/*
+ * replace.c
+ * 
+ * Page replacement policies for demand paging, choosing which
+ * page in memory to replace when a page fault occurs and memory
+ * is full. Written for project 2 of COMP30023 Computer Systems,
+ * semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef REPLACE_H
+#define REPLACE_H
+
+#include "sys.h"
+
+// Number of past references used by LRU-K
+#ifndef LRUK_K
+#define LRUK_K 2
+#endif
+
+/*
+ * Replacement state of a memory page. Nodes after the memory
+ * pages are ghosts, remembering pages recently replaced by ARC.
+ * 
+ * int prev, next:   Neighbouring nodes in the list holding this node.
+ * int list:         List holding this node, or UNDEF if none.
+ * int ref:          Reference bit for CLOCK and second-chance.
+ * Time hist:        Times of the most recent references, newest first.
+ * int pix, vpn:     Process and page the node remembers (if a ghost).
+ */
+typedef struct Frame {
+    int prev, next, list, ref;
+    Time hist[LRUK_K];
+    int pix, vpn;
+} Frame;
+
+/*
+ * State shared by all replacement policies.
+ * 
+ * Policy policy:  Replacement policy in use.
+ * Frame *frames:  Memory pages followed by ARC ghosts.
+ * int n:          Number of memory pages.
+ * int head, tail: First and last node of each list.
+ * int size:       Number of nodes in each list.
+ * int hand:       Next memory page considered by CLOCK.
+ * Heap *heap:     Memory pages ordered by K-th most recent reference.
+ * int *spare:     Stack of unused ghost nodes.
+ * int n_spare:    Number of unused ghost nodes.
+ * int target:     Adaptive target size of ARC's recency list.
+ * int promote:    Flag for the page being loaded having been a ghost.
+ */
+typedef struct Replacer {
+    Policy policy;
+    Frame *frames;
+    int n;
+    int head[4], tail[4], size[4];
+    int hand;
+    Heap *heap;
+    int *spare, n_spare;
+    int target, promote;
+} Replacer;
+
+/*
+ * qsort comparison function for the K-th most recent reference
+ * to a page, then the most recent. Pages referenced fewer than K
+ * times come first.
+ */
+int compare_kth(const void *a, const void *b);
+
+/*
+ * Allocates the replacement state for the memory of an OS.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void replace_init(System *sys);
+
+/*
+ * Frees the replacement state of an OS.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void replace_free(System *sys);
+
+/*
+ * Chooses the memory page to load a missing page into, updating
+ * the policy's history. If a free page is given it is used,
+ * otherwise another page is chosen to be replaced and is removed
+ * from the policy but left for the caller to evict.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int vpn:     Missing page of the process in the current context.
+ * int addr:    Memory address of a free page, or UNDEF if full.
+ * 
+ * Returns int: Memory address to load the page into.
+ */
+int replace_miss(System *sys, int vpn, int addr);
+
+/*
+ * Adds a newly loaded page to the policy. Counts as the first
+ * reference to the page.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ */
+void replace_insert(System *sys, int addr);
+
+/*
+ * Records a reference to a page in memory.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ */
+void replace_touch(System *sys, int addr);
+
+/*
+ * Removes a page from the policy when it is freed. Does nothing
+ * if the page is not held by the policy.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ */
+void replace_remove(System *sys, int addr);
+
+#endif
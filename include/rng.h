@@ -0,0 +1,50 @@
+/*
+ * rng.c
+ * 
+ * A small, seedable pseudo-random number generator giving
+ * independent streams for each process so that simulations are
+ * reproducible. Written for project 2 of COMP30023 Computer
+ * Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+#ifndef DEFAULT_SEED
+#define DEFAULT_SEED 30023
+#endif
+
+/*
+ * Derives the starting state of an independent stream.
+ * 
+ * uint64_t seed:   Seed shared by every stream in a simulation.
+ * uint64_t stream: Identifier of the stream, e.g. a process ID.
+ * 
+ * Returns uint64_t: Starting state of the stream.
+ */
+uint64_t rng_seed(uint64_t seed, uint64_t stream);
+
+/*
+ * Advances a stream and returns its next value.
+ * 
+ * uint64_t *state: Pointer to the state of a stream.
+ * 
+ * Returns uint64_t: Uniformly distributed 64 bit value.
+ */
+uint64_t rng_next(uint64_t *state);
+
+/*
+ * Advances a stream and returns its next value as a fraction.
+ * 
+ * uint64_t *state: Pointer to the state of a stream.
+ * 
+ * Returns double: Uniformly distributed value in [0, 1).
+ */
+double rng_uniform(uint64_t *state);
+
+#endif
@@ -7,8 +7,63 @@
 
 #define ceil(x) (x > (float)((int)x) ? (int)x + 1 : (int)x)
 
-typedef enum notification { RUN, FINISH, EVICT } Notification;
+// Exact ceiling of a / b for positive integers of any width
+#define ceil_div(a, b) (((a) + (b) - 1) / (b))
+
+typedef enum notification { RUN, FINISH, EVICT, BLOCK } Notification;
 
 void notify(Notification n, System sys, int var, ...);
 
+/*
+ * Prints statistics for processes that have finished, gathered
+ * as they finished.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void print_stats(System *sys);
+
+/*
+ * Reads the name of a process scheduling algorithm.
+ * 
+ * char *name: ff, rr, cs, mlfq, srtf, cfs or ma.
+ * 
+ * Returns int: Enumerated scheduling algorithm, or UNDEF if unknown.
+ */
+int get_scheduler(char *name);
+
+/*
+ * Reads the name of a memory allocation algorithm, where demand
+ * paging is named by its page replacement policy.
+ * 
+ * char *name:  u, p, v or cm, or d, lru, clock, sc, lruk or arc.
+ * int *policy: Set to the page replacement policy if demand paging,
+ *              otherwise UNDEF.
+ * 
+ * Returns int: Enumerated allocation algorithm, or UNDEF if unknown.
+ */
+int get_allocator(char *name, int *policy);
+
+/*
+ * Reads a process from a line holding its arrival time, ID, memory
+ * and job time, optionally followed by key=value attributes.
+ * 
+ * char *line: Line to read, which is changed.
+ * Process *p: Pointer to the process to initialise.
+ * 
+ * Returns int: 1 if the line held a process, 0 otherwise.
+ */
+int read_process(char *line, Process *p);
+
+/*
+ * Loads processes from a file to a process table. Each line holds
+ * the arrival time, ID, memory and job time of a process, optionally
+ * followed by key=value attributes.
+ * 
+ * char *filename: File containing process metadata.
+ * Process *p:     Array of processes.
+ * 
+ * Returns int: Number of processes loaded.
+ */
+int get_procs_from_file(char *filename, Process **p);
+
 #endif
@@ -0,0 +1,92 @@
+/*
+ * series.c
+ *
+ * Periodic samples of the load on the OS written to a file as it
+ * runs, taken from counters kept as the OS changes rather than by
+ * scanning. Written for project 2 of COMP30023 Computer Systems,
+ * semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef SERIES_H
+#define SERIES_H
+
+#include <stdio.h>
+
+#include "sys.h"
+
+// Files with this extension are written as binary samples, others as CSV
+#define SERIES_BINARY ".bin"
+
+/*
+ * A sample, as written to binary files.
+ *
+ * Time time:    Time of the sample.
+ * int ready:    Number of processes waiting to run.
+ * int resident: Number of processes with pages in memory.
+ * int loads:    Number of transfers outstanding on the backing store.
+ * float memory: Percentage of memory pages allocated.
+ * float busy:   Fraction of the interval before the sample spent running processes.
+ */
+typedef struct Sample {
+    Time time;
+    int ready, resident, loads;
+    float memory, busy;
+} Sample;
+
+/*
+ * Samples being written for an OS.
+ *
+ * FILE *file:       File the samples are written to.
+ * int binary:       Flag for writing Sample structs rather than CSV.
+ * int interval:     Time between samples.
+ * Time next:        Time of the next sample.
+ * long long busy:   Time spent running processes before the most recent run.
+ * long long sampled: Time spent running processes before the previous sample.
+ * Time run_start:   Time the most recent run started.
+ * Time run_end:     Time the most recent run ended.
+ */
+typedef struct Series {
+    FILE *file;
+    int binary, interval;
+    Time next;
+    long long busy, sampled;
+    Time run_start, run_end;
+} Series;
+
+/*
+ * Starts sampling an OS, from its current time.
+ *
+ * System *sys:    Pointer to an OS struct.
+ * char *filename: File to write samples to.
+ * int interval:   Time between samples.
+ */
+void series_init(System *sys, char *filename, int interval);
+
+/*
+ * Writes any samples due up to the current time and stops sampling.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void series_free(System *sys);
+
+/*
+ * Writes every sample due before the current time. The OS must not
+ * have changed since the time of the earliest of them.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void series_sample(System *sys);
+
+/*
+ * Records that the process in the current context ran from the
+ * given time until the current time, and writes samples due.
+ *
+ * System *sys: Pointer to an OS struct.
+ * Time start:  Time the process started running.
+ */
+void series_run(System *sys, Time start);
+
+#endif
@@ -14,6 +14,11 @@
 
 #include "sys.h"
 
+/*
+ * qsort comparison function for process job time.
+ */
+int compare_job(const void* a, const void* b);
+
 /*
  * Handles a clock cycle for the OS according to
  * Shortest-Job-First scheduling.
@@ -14,6 +14,17 @@
 
 #include "sys.h"
 
+/*
+ * Finds the number of pages the process in the current context is
+ * given, being the surplus pages held by larger ready processes,
+ * but at least enough to begin running.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * 
+ * Returns int: Number of pages it needs in memory to run.
+ */
+int smallswap_target(System *sys);
+
 /*
  * Performs memory swapping with the goal of keeping the entirety of
  * smaller processes in memory and only forcing the largest processes
@@ -0,0 +1,30 @@
+/*
+ * srtf.c
+ * 
+ * A preemptive Shortest-Remaining-Time-First process scheduling
+ * algorithm to run for a process scheduling simulator. Written
+ * for project 2 of COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef SRTF_H
+#define SRTF_H
+
+#include "sys.h"
+
+/*
+ * qsort comparison function for process remaining time.
+ */
+int compare_remaining(const void *a, const void *b);
+
+/*
+ * Handles a clock cycle for the OS according to
+ * Shortest-Remaining-Time-First scheduling.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void srtf_step(System *sys);
+
+#endif
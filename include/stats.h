@@ -0,0 +1,132 @@
+/*
+ * stats.c
+ *
+ * Statistics of finished processes, gathered as each one finishes
+ * so that none need the process table afterwards, with quantile
+ * sketches for the tails of their distributions. Written for
+ * project 2 of COMP30023 Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include "sys.h"
+
+// Values are exact below 2^(SKETCH_BITS + 1), then within 1/2^SKETCH_BITS
+#define SKETCH_BITS    5
+#define SKETCH_SUB     (1 << SKETCH_BITS)
+#define SKETCH_BUCKETS ((64 - SKETCH_BITS) * SKETCH_SUB)
+
+/*
+ * Log-linear histogram of non-negative values. Each power of two is
+ * split into the same number of buckets, so the error of a quantile
+ * is bounded relative to its value. Sketches are merged by adding
+ * their counts.
+ *
+ * long long counts: Number of values in each bucket.
+ * long long n:      Number of values.
+ */
+typedef struct Sketch {
+    long long counts[SKETCH_BUCKETS];
+    long long n;
+} Sketch;
+
+/*
+ * Statistics of finished processes. Processes finish in order of
+ * time, so throughput is counted one epoch at a time.
+ *
+ * Sketch turnaround:    Turnaround times.
+ * Sketch waiting:       Turnaround times less job times.
+ * Sketch overhead:      Time overheads, in hundredths.
+ * Sketch queueing:      Times waiting to be admitted.
+ * long long turnaround_total: Sum of turnaround times.
+ * long long queueing_total: Sum of times waiting to be admitted.
+ * Time queueing_max:    Longest time waiting to be admitted.
+ * double overhead_total: Sum of time overheads.
+ * float overhead_max:   Largest time overhead.
+ * Time makespan:        Time the last process finished.
+ * long long epoch:      Epoch being counted.
+ * int epoch_finished:   Processes finished in the epoch being counted.
+ * long long epochs:     Number of epochs counted.
+ * int tp_min:           Fewest processes finished in an epoch counted.
+ * int tp_max:           Most processes finished in an epoch counted.
+ * long long tp_total:   Processes finished in the epochs counted.
+ * long long cpu_total:  Sum of job times.
+ * long long io_total:   Sum of I/O burst times, as each one starts.
+ * int blocks:           Number of I/O bursts started.
+ */
+typedef struct Stats {
+    Sketch turnaround, waiting, overhead, queueing;
+    long long turnaround_total, queueing_total;
+    Time queueing_max;
+    double overhead_total;
+    float overhead_max;
+    Time makespan;
+    long long epoch, epochs;
+    int epoch_finished, tp_min, tp_max;
+    long long tp_total;
+    long long cpu_total, io_total;
+    int blocks;
+} Stats;
+
+/*
+ * Adds a value to a sketch.
+ *
+ * Sketch *s:      Pointer to a sketch.
+ * long long value: Value to add, negative values are counted as 0.
+ */
+void sketch_add(Sketch *s, long long value);
+
+/*
+ * Adds every value in one sketch to another.
+ *
+ * Sketch *to:   Pointer to the sketch to add to.
+ * Sketch *from: Pointer to the sketch to add.
+ */
+void sketch_merge(Sketch *to, Sketch *from);
+
+/*
+ * Finds the value at a quantile of a sketch.
+ *
+ * Sketch *s: Pointer to a sketch.
+ * double q:  Quantile between 0 and 1.
+ *
+ * Returns long long: Middle of the bucket holding the quantile, or 0
+ *                    if the sketch is empty.
+ */
+long long sketch_quantile(Sketch *s, double q);
+
+/*
+ * Allocates statistics for an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void stats_init(System *sys);
+
+/*
+ * Frees the statistics of an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void stats_free(System *sys);
+
+/*
+ * Records a process that has just finished.
+ *
+ * System *sys: Pointer to an OS struct.
+ * Process *p:  Pointer to the process.
+ */
+void stats_finish(System *sys, Process *p);
+
+/*
+ * Counts every epoch up to the makespan, which must be called once
+ * every process has finished.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void stats_close(System *sys);
+
+#endif
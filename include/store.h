@@ -0,0 +1,118 @@
+/*
+ * store.c
+ * 
+ * A backing store that loads pages into memory in the background
+ * with a bounded bandwidth, so that other processes may run while
+ * a process waits for its pages. Written for project 2 of
+ * COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef STORE_H
+#define STORE_H
+
+#include "sys.h"
+
+/*
+ * Backing store device. Transfers are served one at a time in the
+ * order they were requested, so they also finish in that order.
+ * 
+ * Queue *queue:   Processes with a transfer not yet received.
+ * int bandwidth:  Number of pages transferred at the same time.
+ * int prefetch:   Flag for loading the next process' pages early.
+ * Time free:      Time the device finishes every transfer requested.
+ * Time busy:      Total time spent transferring pages.
+ * int requests:   Number of transfers requested.
+ * int depth_max:  Most transfers outstanding at once.
+ * long long depth_total: Sum of transfers outstanding at each request.
+ * int prefetched: Number of pages loaded ahead of being dispatched.
+ * int stalled:    Flag for the CPU waiting on the backing store to dispatch.
+ * int waiting:    Number of processes in the LOADING state.
+ */
+typedef struct Store {
+    Queue *queue;
+    int bandwidth, prefetch;
+    Time free, busy;
+    int requests, depth_max;
+    long long depth_total;
+    int prefetched, stalled, waiting;
+} Store;
+
+/*
+ * Allocates a backing store for an OS.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void store_init(System *sys);
+
+/*
+ * Frees the backing store of an OS.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void store_free(System *sys);
+
+/*
+ * Checks whether a process' pages are being transferred, or have
+ * been transferred but not yet used, in which case they may not
+ * be evicted.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int i:       Index in the process table of the process.
+ * 
+ * Returns int: Evaluates to true if the pages are pinned.
+ */
+int pinned(System *sys, int i);
+
+/*
+ * Makes sure the process in the current context can be given the
+ * pages it needs without evicting pages being transferred, waiting
+ * for the backing store to finish every transfer if not.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * 
+ * Returns int: Evaluates to true if the CPU stalled waiting.
+ */
+int store_reserve(System *sys);
+
+/*
+ * Requests the pages just allocated to the process in the current
+ * context from the backing store. The process waits in the LOADING
+ * state unless the CPU has already stalled for the backing store,
+ * in which case it waits for the pages as its load time.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int stalled: Flag for the CPU having stalled for the backing store.
+ * 
+ * Returns Status: LOADING if the process must wait, RUNNING otherwise.
+ */
+Status store_load(System *sys, int stalled);
+
+/*
+ * Loads pages of the process scheduled to run next into free
+ * memory while the process in the current context runs.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void store_prefetch(System *sys);
+
+/*
+ * Receives finished transfers, handing processes that were waiting
+ * for them back to the scheduling algorithm.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void store_poll(System *sys);
+
+/*
+ * Finds when the next transfer will finish.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * 
+ * Returns Time: Time the next transfer finishes, or UNDEF if none.
+ */
+Time store_next(System *sys);
+
+#endif
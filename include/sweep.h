@@ -0,0 +1,93 @@
+/*
+ * sweep.c
+ *
+ * Sweeps over a grid of traces, algorithms and settings, split into
+ * shards that workers claim from a work queue of files in a shared
+ * directory, so that workers may run on any machine that can see it.
+ * Results are kept with the queue, so a sweep stopped part way is
+ * resumed by running it again. Written for project 2 of COMP30023
+ * Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "sys.h"
+
+// Directory of the work queue when none is given
+#define SWEEP_DIR "sweep"
+
+// Runs in each shard when the grid does not give a number
+#ifndef SWEEP_SHARD
+#define SWEEP_SHARD 4
+#endif
+
+// Times a shard may be given up by a worker that died before the sweep stops
+#define SWEEP_RETRIES 3
+
+// Seconds between checks on shards claimed by workers elsewhere
+#define SWEEP_POLL 1
+
+typedef enum axis { TRACES, SCHEDULERS, ALLOCATORS, MEMORIES, QUANTA, N_AXES } Axis;
+
+/*
+ * Grid of runs in a sweep, one for every combination of the values
+ * of each axis, with the first axis changing slowest.
+ *
+ * char **values: Values of each axis, as given in the grid file.
+ * int n:         Number of values of each axis.
+ * int cells:     Number of runs in the grid.
+ * int shard:     Number of runs in each shard.
+ * int shards:    Number of shards.
+ */
+typedef struct Grid {
+    char **values[N_AXES];
+    int n[N_AXES];
+    int cells, shard, shards;
+} Grid;
+
+/*
+ * Reads a grid from a file, where each line names an axis followed by
+ * its values, as trace, scheduler, allocator, memory or quantum, or
+ * gives the number of runs in each shard, as shard. Every value is
+ * checked, including that each memory size is enough for every
+ * allocator to run the largest process of each trace, and axes not
+ * given have the value used by default.
+ *
+ * char *filename: File containing the grid.
+ *
+ * Returns Grid*: Pointer to the new grid.
+ */
+Grid *grid_init(char *filename);
+
+/*
+ * Frees a grid.
+ *
+ * Grid *g: Pointer to a grid.
+ */
+void grid_free(Grid *g);
+
+/*
+ * Runs a sweep over a grid, queueing every shard without results and
+ * running workers until every shard has results, then prints the
+ * statistics of every run as one table. Shards claimed by workers that
+ * died on this machine are queued again, and shards claimed by workers
+ * elsewhere are waited for.
+ *
+ * char *dir:   Directory of the work queue, made if it does not exist.
+ * Grid *g:     Pointer to the grid, which must be the same if resuming.
+ * int workers: Number of workers to run, or 0 for one per processor.
+ */
+void sweep(char *dir, Grid *g, int workers);
+
+/*
+ * Claims and runs shards from a work queue until it is empty.
+ *
+ * char *dir: Directory of the work queue.
+ */
+void sweep_work(char *dir);
+
+#endif
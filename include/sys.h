@@ -16,6 +16,12 @@
 #define PAGE_SIZE 4
 #endif
 
+#include <stdio.h>
+#include <stdint.h>
+
+#include "queue.h"
+#include "heap.h"
+#include "pheap.h"
 
 #define PAGE_LOAD_TIME 2
 #define MIN_MEM        16
@@ -31,11 +37,16 @@
 #define min(a, b) (a < b ? a : b)
 #define max(a, b) (a > b ? a : b)
 
+// Simulated time, wide enough for long traces at a fine resolution
+typedef long long Time;
+
 /**** ENUM DEFINITIONS ****/
 
-typedef enum status { ERROR, INIT, START, READY, LOADING, RUNNING, TERMINATED } Status;
-typedef enum scheduler { FF, RR, CS } Scheduler;
-typedef enum allocator { U, SWP, V, CM } Allocator;
+typedef enum status { ERROR, INIT, START, READY, LOADING, RUNNING, BLOCKED, TERMINATED } Status;
+typedef enum scheduler { FF, RR, CS, MLFQ, SRTF, CFS, MA, CP } Scheduler;
+typedef enum allocator { U, SWP, V, CM, D } Allocator;
+typedef enum access { DEFAULT, UNIFORM, ZIPF, SEQUENTIAL } Access;
+typedef enum policy { LRU, CLOCK, SC, LRUK, ARC } Policy;
 
 /**** STRUCT DEFINITIONS ****/
 
@@ -43,43 +54,81 @@ typedef enum allocator { U, SWP, V, CM } Allocator;
  * Process time struct for tracking process metadata and
  * for calculating running statistics.
  * 
- * int arrived:   Arrival time of process.
- * int job:       Total time required to complete process.
- * int remaining: Remaining time required to complete process.
- * int started:   Time that the process began running.
- * int last:      Time of the process' last state change.
- * int finished:  Time that the process was completed.
- * int load:      Time most recently spent loading pages into memory.
+ * Time arrived:   Arrival time of process.
+ * Time job:       Total time required to complete process.
+ * Time remaining: Remaining time required to complete process.
+ * Time started:   Time that the process began running.
+ * Time last:      Time of the process' last state change.
+ * Time finished:  Time that the process was completed.
+ * Time load:      Time most recently spent loading pages into memory.
+ * Time fault:     Total time spent resolving page faults.
+ * Time admitted:  Time that the process was admitted, once there was memory for it.
  */
 typedef struct PTime {
-    int arrived, job, remaining, started, last, finished, load;
+    Time arrived, job, remaining, started, last, finished, load, fault, admitted;
 } PTime;
 
 /*
  * Memory page.
  * 
- * int pid: Process ID that this page is allocated to.
- * int pix: Index within the the allocated process' array of Pages.
+ * int pid:  Process ID that this page is allocated to.
+ * int pix:  Index within the the allocated process' array of Pages.
+ * int vpn:  Index of the page within the process (if demand paging).
+ * Time used: Time the page was last referenced or allocated.
  */
 typedef struct Page {
-    int pid, pix;
+    int pid, pix, vpn;
+    Time used;
 } Page;
 
 /*
- * Process struct for use in a process table.
+ * Process struct for use in a process table. Its status is kept
+ * in the process table instead.
  * 
- * Status status: Current state of the process.
  * PTime time:    Process Time struct to track process metadata.
- * Page **pages:  Array of memory addresses allocated to the process.
+ * Page **pages:  Page table of the process (if demand paging).
  * int id:        Process ID.
  * int mem:       Memory required (in KB).
  * int n_pages:   Number of pages in memory.
+ * int level:     Priority level for multi-level feedback queue scheduling.
+ * int weight:    Share of the CPU relative to other processes.
+ * long long vruntime: CPU time received, scaled inversely by weight.
+ * Access access: Pattern of page references (if demand paging).
+ * uint64_t rng:  Random number stream for page references.
+ * int cursor:    Next page referenced by sequential access.
+ * int faults:    Number of page faults.
+ * int ws:        Distinct pages referenced since last dispatched.
+ * int ws_max:    Largest working set over all dispatches.
+ * int *ghost:    Replacement history node of each page (if applicable).
+ * Time io:       Time its pages finish loading from the backing store, or UNDEF
+ *                if it has run since.
+ * int extents:   Number of contiguous runs of pages it has in memory.
+ * int *after:    IDs of the processes it waits for to finish (if any).
+ * int n_after:   Number of processes it waits for.
+ * Time critical: Longest chain of job times from it through the processes
+ *                waiting for it.
+ * Time *bursts:  Lengths of its CPU and I/O bursts, alternating (if any).
+ * int n_bursts:  Number of bursts.
+ * int next_burst: Index in bursts of the I/O burst after its current CPU burst.
+ * Time burst:    CPU time left before it next blocks, or UNDEF if it won't.
+ * Time wake:     Time its I/O completes, while blocked.
  */
 typedef struct Process {
-    Status status;
     PTime time;
     Page **pages;
-    int id, mem, n_pages;
+    int id, mem, n_pages, level, weight;
+    long long vruntime;
+    Access access;
+    uint64_t rng;
+    int cursor, faults, ws, ws_max;
+    int *ghost;
+    Time io;
+    int extents;
+    int *after, n_after;
+    Time critical;
+    Time *bursts;
+    int n_bursts, next_burst;
+    Time burst, wake;
 } Process;
 
 /*
@@ -87,14 +136,18 @@ typedef struct Process {
  * 
  * Status status: Current state of the process.
  * Process *p:    Array of processes.
+ * Status *states: Current state of each process, apart from the processes
+ *                so that scans for ready processes read contiguous memory.
  * int n:         Number of processes in table.
  * int n_alive:   Number of processes that haven't been terminated.
  * int context:   Index of process in the current context.
+ * int next:      Index of the next process to arrive.
  */
 typedef struct PTable {
     Status status;
     Process *p;
-    int n, n_alive, context;
+    Status *states;
+    int n, n_alive, context, next;
 } PTable;
 
 /*
@@ -104,21 +157,104 @@ typedef struct PTable {
  * Status status:       Current state of the system.
  * PTable table:        Process table.
  * Page *pages:         Memory pages;
+ * Frames *frames:      Owner of each memory page, for scanning memory.
+ * Arena *arena:        Page tables of every process (if demand paging).
  * Scheduler scheduler: Process scheduling algorithm to use.
  * Allocator allocator: Memory allocation algorithm to use.
- * int time:            Current system time.
+ * Time time:           Current system time.
  * int quantum:         Quantum time limit for a process (if applicable).
  * int mem_size:        System memory size (in KB).
  * int page_size:       Memory page size (in KB).
  * int n_pages:         Number of memory pages.
+ * int n_used:          Number of memory pages allocated to a process.
+ * int n_resident:      Number of processes with pages in memory.
+ * double admission:    Most memory admitted processes may need, as a ratio of mem_size, or 0 for no limit.
+ * Heap *pending:       Arrived processes waiting to be admitted, in scheduling order (if applicable).
+ * long long committed: Memory needed by admitted processes that have not finished (in KB).
+ * Dag *dag:            Dependencies between processes (if any).
+ * Heap *waiting:       Blocked processes in order of wake time.
+ * int evict_blocked:   Flag for evicting the pages of a process when it blocks.
+ * Heap *ready:         Ready processes in scheduling order (if applicable).
+ * Heap *aged:          Ready processes in order of time last run (if applicable).
+ * int aging:           Longest time a process waits before it must run (if applicable).
+ * Queue **queues:      Ready queue for each priority level (if applicable).
+ * int levels:          Number of priority levels (if applicable).
+ * int boost:           Time between priority boosts (if applicable).
+ * Time boosted:        Time of the most recent priority boost.
+ * PHeap *tree:         Processes ordered by virtual runtime (if applicable).
+ * long long min_vruntime: Smallest virtual runtime of any received process.
+ * int granularity:     Minimum time a process runs once dispatched.
+ * int weight_total:    Total weight of all received processes.
+ * int batch:           Flag for handling all events at the same time together.
+ * Queue *fifo:         Ready processes in Round-Robin order (if batching).
+ * int *evicted:        Addresses evicted at the current time (if batching).
+ * int n_evicted:       Number of addresses evicted at the current time.
+ * Access access:       Pattern of page references for processes without one.
+ * uint64_t seed:       Seed for all random number streams.
+ * Policy policy:       Page replacement policy (if demand paging).
+ * Replacer *replacer:  Page replacement state (if demand paging).
+ * int bandwidth:       Pages the backing store loads at once, or 0 to load synchronously.
+ * int prefetch:        Flag for loading the next process' pages early.
+ * Store *store:        Backing store loading pages in the background (if applicable).
+ * int fragmentation:   Flag for tracking memory fragmentation.
+ * int compaction:      Time to relocate a page when compacting, or UNDEF to never compact.
+ * Frag *frag:          Memory fragmentation state (if applicable).
+ * Time checkpoint:     Time to save the state of the OS at, or UNDEF.
+ * char *checkpoint_file: File to save the state of the OS to.
+ * Snapshot *snapshot:  State restored from a checkpoint, until it is run.
+ * FILE *out:           Stream events and statistics are printed to.
+ * Verifier *verifier:  Run being checked against golden output (if applicable).
+ * Profile *profile:    Counters for each phase of the OS (if applicable).
+ * Series *series:      Samples written as the OS runs (if applicable).
+ * Stats *stats:        Statistics of finished processes.
+ * int percentiles:     Flag for printing percentiles of finished processes.
+ * Online *online:      Arrivals read as the OS runs (if applicable).
  */
 typedef struct System {
     Status status;
     PTable table;
     Page *pages;
+    struct Frames *frames;
+    struct Arena *arena;
     Scheduler scheduler;
     Allocator allocator;
-    int time, quantum, mem_size, page_size, n_pages;
+    Time time;
+    int quantum, mem_size, page_size, n_pages, n_used, n_resident;
+    double admission;
+    Heap *pending;
+    long long committed;
+    struct Dag *dag;
+    Heap *waiting;
+    int evict_blocked;
+    Heap *ready, *aged;
+    int aging;
+    Queue **queues;
+    int levels, boost;
+    Time boosted;
+    PHeap *tree;
+    long long min_vruntime;
+    int granularity, weight_total;
+    int batch;
+    Queue *fifo;
+    int *evicted, n_evicted;
+    Access access;
+    uint64_t seed;
+    Policy policy;
+    struct Replacer *replacer;
+    int bandwidth, prefetch;
+    struct Store *store;
+    int fragmentation, compaction;
+    struct Frag *frag;
+    Time checkpoint;
+    char *checkpoint_file;
+    struct Snapshot *snapshot;
+    FILE *out;
+    struct Verifier *verifier;
+    struct Profile *profile;
+    struct Series *series;
+    struct Stats *stats;
+    int percentiles;
+    struct Online *online;
 } System;
 
 /**** HEADER FILES ****/
@@ -129,26 +265,78 @@ typedef struct System {
 #include "rr.h"
 #include "sjf.h"
 #include "smlswp.h"
+#include "mlfq.h"
+#include "srtf.h"
+#include "cfs.h"
+#include "ma.h"
+#include "rng.h"
+#include "demand.h"
+#include "replace.h"
+#include "store.h"
+#include "frag.h"
+#include "checkpoint.h"
+#include "verify.h"
+#include "profile.h"
+#include "series.h"
+#include "stats.h"
+#include "frames.h"
+#include "arena.h"
+#include "online.h"
+#include "dag.h"
+#include "burst.h"
 
 /**** FUNCTION DEFINITIONS ****/
 
+/*
+ * qsort comparison function for process arrival time.
+ */
+int compare(const void *a, const void *b);
+
 /*
  * Comparison function for qsort that compares integer values.
  */
 int compare_int(const void *a, const void *b);
 
 /*
- * Creates and allocated memory for a new process with 
- * initialised values.
+ * Initialises a process in place, such as in the process table.
+ * Its page table is only made if it is demand paged.
+ * 
+ * Process *p:    Pointer to the process.
+ * int id:        Process ID.
+ * int mem:       Memory required (in KB).
+ * Time t_arrived: The time that the process arrived.
+ * Time t_job:     Total CPU time required to run the process.
+ */
+void init_process(Process *p, int id, int mem, Time t_arrived, Time t_job);
+
+/*
+ * Lets the scheduling algorithm know that the number of pages
+ * a process has in memory has changed.
+ * 
+ * System *sys: Pointer to the OS.
+ * int i:       Index in the process table of the process.
+ */
+void residency_changed(System *sys, int i);
+
+/*
+ * Hands a process back to the scheduling algorithm after it
+ * waited for its pages to load.
+ * 
+ * System *sys: Pointer to the OS.
+ * int i:       Index in the process table of the process.
+ */
+void requeue(System *sys, int i);
+
+/*
+ * Finds the process the scheduling algorithm will most likely
+ * run next, without changing the current context.
  * 
- * int id:
- * int mem:
- * int t_arrived: The time that the process arrived.
- * int t_job:     Total CPU time required to run the process.
+ * System *sys: Pointer to the OS.
  * 
- * Returns Process*: Pointer to the new Process struct.
+ * Returns int: Index in the process table of the process, or UNDEF
+ *              if unknown.
  */
-Process *create_process(int id, int mem, int t_arrived, int t_job);
+int upcoming(System *sys);
 
 /*
  * Finds the least recently allocated process in the
@@ -160,27 +348,73 @@ Process *create_process(int id, int mem, int t_arrived, int t_job);
  */
 int oldest(System sys);
 
+/*
+ * Receives a process that has arrived, or has it wait to be admitted
+ * behind any processes already waiting or until there is memory.
+ * 
+ * System *sys:  Pointer to the OS.
+ * int i:        Index in the process table of the process.
+ * Time arrived: Time it arrived, or was released by its parents.
+ */
+void arrive(System *sys, int i, Time arrived);
+
+/*
+ * Checks for newly arrived processes.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void get_processes(System *sys);
+
+/*
+ * Finds when the next process that has not yet been received
+ * will arrive.
+ * 
+ * System sys: OS data structure.
+ * 
+ * Returns Time: Arrival time of the next process, or UNDEF if
+ *              all processes have been received.
+ */
+Time next_arrival(System sys);
+
 /*
  * Begins running the process in the current context and evitcts
  * memory to allow it to run.
  * 
  * System *sys: Pointer to an OS.
+ * 
+ * Returns Status: LOADING if the process is waiting for its pages
+ *                 to load in the background, RUNNING otherwise.
+ */
+Status process_start(System *sys);
+
+/*
+ * Runs the process in the current context, advancing the clock
+ * by the time given plus any time it is stalled by page faults.
+ * 
+ * System *sys:  Pointer to an OS struct.
+ * Time runtime: CPU time to run the process for.
  */
-void process_start(System *sys);
+void process_run(System *sys, Time runtime);
 
 /*
- * Pauses the currently running process.
+ * Pauses the currently running process, blocking it instead if
+ * it has reached the end of a CPU burst.
  * 
  * System *sys: Pointer to an OS struct.
+ * 
+ * Returns Status: BLOCKED if it is waiting for I/O, READY otherwise.
  */
-void process_pause(System *sys);
+Status process_pause(System *sys);
 
 /*
  * Resumes a paused process.
  * 
  * System *sys: Pointer to an OS struct.
+ * 
+ * Returns Status: LOADING if the process is waiting for its pages
+ *                 to load in the background, RUNNING otherwise.
  */
-void process_resume(System *sys);
+Status process_resume(System *sys);
 
 /*
  * Performs termination of a process and evicts its memory.
@@ -189,6 +423,40 @@ void process_resume(System *sys);
  */
 void process_finish(System *sys);
 
+/*
+ * Creates a process table, sorting its processes in place.
+ * 
+ * Process *p: Pointer to array of Processes for the process table.
+ * int n:      Number of processes.
+ * 
+ * Returns PTable*: Pointer to the new process table.
+ */
+PTable *create_table(Process *p, int n);
+
+/*
+ * Creates an OS ready to run with default values for any
+ * algorithm specific settings, which may be changed before
+ * it is run.
+ * 
+ * Process *p:  Pointer to array of Processes for the process table.
+ * int n:       Number of processes.
+ * Scheduler s: Enumerated value for which scheduling algorithm to use.
+ * Allocator a: Enumerated value for which memory allocation algorithm to use.
+ * int m:       System memory size.
+ * int q:       Quantam time for scheduling.
+ * 
+ * Returns System*: Pointer to the new OS struct.
+ */
+System *create_system(Process *p, int n, Scheduler s, Allocator a, int m, int q);
+
+/*
+ * Handles all dispatch to run the OS until every process
+ * has been terminated.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void run(System *sys);
+
 /*
  * Begins running and handles all dispatch to continue running
  * the OS.
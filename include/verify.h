@@ -0,0 +1,81 @@
+/*
+ * verify.c
+ *
+ * Replays a run against golden output recorded from an earlier run,
+ * checking that every event and statistic is unchanged and that the
+ * run has not slowed down. Written for project 2 of COMP30023
+ * Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#ifndef VERIFY_H
+#define VERIFY_H
+
+#include <time.h>
+
+#include "sys.h"
+
+// Slowest a run may be relative to its baseline before failing
+#define VERIFY_TOLERANCE 1.25
+
+// CPU time in seconds too short to measure reliably
+#define VERIFY_SLACK 0.005
+
+/*
+ * State of a run being verified. Output is captured in memory until
+ * the run finishes so it can be compared with the golden output.
+ *
+ * char *golden:    File holding the golden output.
+ * char *output:    Output captured from the run.
+ * size_t len:      Length of the captured output.
+ * double baseline: CPU time in seconds of the golden run, or 0 if unknown.
+ * double load:     CPU time in seconds taken to load the processes.
+ * clock_t start:       CPU time the simulation started at.
+ * uint64_t cycles:     Cycle count the simulation started at.
+ * uint64_t formatting: Cycles spent formatting events and statistics.
+ */
+typedef struct Verifier {
+    char *golden, *output;
+    size_t len;
+    double baseline, load;
+    clock_t start;
+    uint64_t cycles, formatting;
+} Verifier;
+
+/*
+ * Starts verifying or timing an OS, capturing its output from now on.
+ *
+ * System *sys:     Pointer to an OS struct.
+ * char *golden:    File holding the golden output, or NULL to only time.
+ * double baseline: CPU time in seconds of the golden run, or 0 if unknown.
+ * double load:     CPU time in seconds taken to load the processes.
+ */
+void verify_init(System *sys, char *golden, double baseline, double load);
+
+/*
+ * Counts the cycles since the given cycle count as spent formatting
+ * output rather than simulating, if the OS is being timed. Cycles
+ * are counted as they are far cheaper to read around every event
+ * than the CPU time.
+ *
+ * System *sys:    Pointer to an OS struct.
+ * uint64_t start: Cycle count the output started being formatted at.
+ */
+void verify_output(System *sys, uint64_t start);
+
+/*
+ * Finishes verifying an OS, printing its captured output and
+ * reporting to stderr the first line that differs from the golden
+ * output, and the CPU time taken loading, simulating and printing
+ * against the baseline.
+ *
+ * System *sys: Pointer to an OS struct.
+ *
+ * Returns int: EXIT_SUCCESS if the output matched and the run was
+ *              not slower than the baseline, EXIT_FAILURE otherwise.
+ */
+int verify(System *sys);
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * arena.c
+ *
+ * A region allocator that hands out zeroed memory from large
+ * chunks and frees everything it handed out at once, for the many
+ * small allocations that live as long as the OS. Written for
+ * project 2 of COMP30023 Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+
+#include "arena.h"
+
+/*
+ * Creates an empty arena.
+ *
+ * size_t chunk: Smallest size of each chunk, ideally the total needed.
+ *
+ * Returns Arena*: Pointer to the new arena.
+ */
+Arena *arena_init(size_t chunk) {
+
+    Arena *a = (Arena*)calloc(1, sizeof(Arena));
+
+    a->chunk = chunk > 0 ? chunk : ARENA_ALIGN;
+
+    return a;
+}
+
+/*
+ * Allocates zeroed memory from an arena, which stays allocated
+ * until the arena is freed.
+ *
+ * Arena *a:    Pointer to an arena.
+ * size_t size: Number of bytes wanted.
+ *
+ * Returns void*: Pointer to the memory.
+ */
+void *arena_alloc(Arena *a, size_t size) {
+
+    Chunk *c = a->head;
+    void *m;
+
+    size = (size + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+
+    // Start a new chunk, at least big enough for the allocation
+    if (c == NULL || c->size - c->used < size) {
+
+        c = (Chunk*)malloc(sizeof(Chunk));
+        c->size = size > a->chunk ? size : a->chunk;
+        c->used = 0;
+        if ((c->data = (char*)calloc(1, c->size)) == NULL) exit(EXIT_FAILURE);
+
+        c->next = a->head;
+        a->head = c;
+    }
+
+    m = c->data + c->used;
+    c->used += size;
+
+    return m;
+}
+
+/*
+ * Frees an arena and everything allocated from it.
+ *
+ * Arena *a: Pointer to an arena, or NULL.
+ */
+void arena_free(Arena *a) {
+
+    Chunk *next;
+
+    if (a == NULL) return;
+
+    for (Chunk *c = a->head; c != NULL; c = next) {
+        next = c->next;
+        free(c->data);
+        free(c);
+    }
+
+    free(a);
+}
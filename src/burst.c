@@ -0,0 +1,207 @@
+/*
+ * burst.c
+ *
+ * Processes that alternate between CPU and I/O bursts, given as
+ * bursts=cpu,io,cpu,... in a trace. A process blocks at the end
+ * of each CPU burst that is followed by an I/O burst, waiting in
+ * order of wake time while other processes run, and is handed back
+ * to the scheduling algorithm once its I/O completes. Written for
+ * project 2 of COMP30023 Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+
+#include "burst.h"
+
+/*
+ * Reads the CPU and I/O bursts of a process, given as a comma
+ * separated list starting with a CPU burst. The job time of the
+ * process is unchanged, so its last CPU burst runs for whatever
+ * is left of it.
+ *
+ * Process *p:  Pointer to a process.
+ * char *value: Lengths of its bursts.
+ */
+void burst_parse(Process *p, char *value) {
+
+    int n = 1;
+    Time length;
+    char *end;
+
+    for (char *c = value; *c; c++) n += *c == ',';
+
+    free(p->bursts);
+    p->bursts = (Time*)malloc(n * sizeof(Time));
+    p->n_bursts = 0;
+
+    // Every burst takes at least 1 unit of time
+    while (*value) {
+        length = strtoll(value, &end, 10);
+        if (end != value) p->bursts[p->n_bursts++] = max(length, 1);
+        value = *end ? end + 1 : end;
+    }
+
+    // Only a CPU burst followed by an I/O burst ends by blocking
+    p->next_burst = 1;
+    p->burst = p->n_bursts > 1 ? p->bursts[0] : UNDEF;
+
+    if (!p->n_bursts) {
+        free(p->bursts);
+        p->bursts = NULL;
+    }
+}
+
+/*
+ * Frees the bursts read for each process.
+ *
+ * Process *p: Array of processes.
+ * int n:      Number of processes.
+ */
+void burst_free_lists(Process *p, int n) {
+
+    for (int i = 0; i < n; i++) {
+        free(p[i].bursts);
+        p[i].bursts = NULL;
+    }
+}
+
+/*
+ * Sets up the queue of blocked processes of an OS, holding any
+ * that were blocked when it was checkpointed.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void burst_init(System *sys) {
+
+    sys->waiting = create_heap((void**)&sys->table.p, sys->table.n, sizeof(Process), compare_wake);
+
+    for (int i = 0; i < sys->table.n; i++) {
+        if (sys->table.states[i] == BLOCKED) heap_push(sys->waiting, i);
+    }
+}
+
+/*
+ * Frees the queue of blocked processes of an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void burst_free(System *sys) {
+
+    free_heap(sys->waiting);
+    sys->waiting = NULL;
+}
+
+/*
+ * Finds how long the process in the current context can run for
+ * before it blocks for I/O.
+ *
+ * System *sys:  Pointer to an OS struct.
+ * Time runtime: Longest time it would otherwise run for.
+ *
+ * Returns Time: The time given, or the time left in its CPU burst
+ *               if that is shorter.
+ */
+Time burst_limit(System *sys, Time runtime) {
+
+    // Shorthand
+    Process *p = &sys->table.p[sys->table.context];
+
+    if (p->burst == UNDEF) return runtime;
+
+    return min(runtime, p->burst);
+}
+
+/*
+ * Blocks the process in the current context, which has just been
+ * paused at the end of a CPU burst, until its I/O burst completes.
+ * Its pages are evicted if blocked processes are not kept resident.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void burst_block(System *sys) {
+
+    // Shorthand
+    Process *p = &sys->table.p[sys->table.context];
+    Stats *s = sys->stats;
+
+    int next = p->next_burst + 1;
+
+    sys->table.states[sys->table.context] = BLOCKED;
+    p->wake = sys->time + p->bursts[p->next_burst];
+
+    s->blocks++;
+    s->io_total += p->bursts[p->next_burst];
+
+    // The burst after next is the last if there is no I/O after it
+    p->next_burst = next + 1;
+    p->burst = next + 1 < p->n_bursts ? p->bursts[next] : UNDEF;
+
+    heap_push(sys->waiting, sys->table.context);
+
+    if (sys->evict_blocked && sys->allocator != U) {
+        evict_process(sys, sys->table.context, p->n_pages);
+    }
+}
+
+/*
+ * Hands every blocked process whose I/O has completed back to the
+ * scheduling algorithm.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void burst_wake(System *sys) {
+
+    int i;
+    Process *p = NULL;
+
+    if (sys->waiting == NULL) return;
+
+    while (sys->waiting->n && sys->table.p[sys->waiting->items[0]].wake <= sys->time) {
+
+        i = heap_pop(sys->waiting);
+        p = &sys->table.p[i];
+
+        sys->table.states[i] = READY;
+        p->time.last = p->wake;
+
+        // Time spent blocked isn't owed back as CPU time
+        if (sys->scheduler == CFS) p->vruntime = max(p->vruntime, sys->min_vruntime);
+
+        requeue(sys, i);
+
+        sys->status = sys->status == TERMINATED ? READY : sys->status;
+    }
+}
+
+/*
+ * Finds when the next blocked process wakes.
+ *
+ * System *sys: Pointer to an OS struct.
+ *
+ * Returns Time: Wake time of the next process, or UNDEF if none
+ *               are blocked.
+ */
+Time burst_next(System *sys) {
+
+    if (sys->waiting == NULL || !sys->waiting->n) return UNDEF;
+
+    return sys->table.p[sys->waiting->items[0]].wake;
+}
+
+/*
+ * qsort comparison function for process wake time.
+ */
+int compare_wake(const void *a, const void *b) {
+
+    const Process *p1 = a, *p2 = b;
+
+    if (p1->wake < p2->wake) return -1;
+    if (p1->wake == p2->wake) {
+        if (p1->id < p2->id) return -1;
+        if (p1->id == p2->id) return 0;
+    }
+    return 1;
+}
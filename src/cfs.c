@@ -0,0 +1,170 @@
+/*
+ * cfs.c
+ * 
+ * A Completely-Fair-Scheduler style process scheduling algorithm
+ * to run for a process scheduling simulator. Written for project
+ * 2 of COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include "cfs.h"
+
+/*
+ * qsort comparison function for process virtual runtime.
+ */
+int compare_vruntime(const void *a, const void *b) {
+
+    const Process *p1 = a, *p2 = b;
+
+    if (p1->vruntime < p2->vruntime) return -1;
+    if (p1->vruntime == p2->vruntime) {
+        if (p1->id < p2->id) return -1;
+        if (p1->id == p2->id) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Allocates the tree of processes ordered by virtual runtime.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void cfs_init(System *sys) {
+
+    sys->tree = create_pheap((void**)&sys->table.p, sys->table.n,
+                             sizeof(Process), compare_vruntime);
+    sys->min_vruntime = 0;
+    sys->weight_total = 0;
+}
+
+/*
+ * Frees the tree of processes ordered by virtual runtime.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void cfs_free(System *sys) {
+
+    free_pheap(sys->tree);
+    sys->tree = NULL;
+}
+
+/*
+ * Receives a newly arrived process, starting it at the smallest
+ * virtual runtime of the processes already received.
+ * 
+ * System *sys: Pointer to the OS.
+ * int i:       Index in the process table of the new process.
+ */
+void cfs_admit(System *sys, int i) {
+
+    // Shorthand
+    Process *p = &sys->table.p[i];
+
+    p->vruntime = max(p->vruntime, sys->min_vruntime);
+    sys->weight_total += p->weight;
+
+    pheap_push(sys->tree, i);
+}
+
+/*
+ * Advances the smallest virtual runtime, which never decreases,
+ * to that of the leftmost process in the tree.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void cfs_update_min(System *sys) {
+
+    if (!sys->tree->n) return;
+
+    sys->min_vruntime = max(sys->min_vruntime,
+                            sys->table.p[sys->tree->root].vruntime);
+}
+
+/*
+ * Updates the current context to be the process with the
+ * smallest virtual runtime.
+ * 
+ * System *sys: Pointer to an OS.
+ * 
+ * returns Status: Enumerated status flag.
+ */
+Status cfs_context(System *sys) {
+
+    // No valid process found
+    if (!sys->tree->n) return TERMINATED;
+
+    sys->table.context = pheap_pop(sys->tree);
+
+    return READY;
+}
+
+/*
+ * Handles a clock cycle for the OS according to
+ * Completely-Fair-Scheduler scheduling.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void cfs_step(System *sys) {
+
+    Time runtime;
+    Process *p = NULL;
+    Status dispatched;
+
+    switch (sys->status) {
+
+        // New process
+        case READY:
+
+            // Update current context, or stop running if no processes available
+            if (profile_context(sys, cfs_context) == TERMINATED) {
+                sys->status = TERMINATED;
+                break;
+            }
+
+            if (sys->table.states[sys->table.context] == START) {
+                dispatched = process_start(sys);
+            } else {
+                dispatched = process_resume(sys);
+            }
+
+            // Dispatch another process while its pages load
+            if (dispatched == LOADING) break;
+
+            sys->status = RUNNING;
+
+            break;
+
+        case RUNNING:
+
+            // Shorthand
+            p = &sys->table.p[sys->table.context];
+
+            // Quantum is shared by weight between all received processes
+            runtime = (long long)sys->quantum * p->weight / sys->weight_total;
+            // Page faults charged on dispatch would otherwise outgrow a short slice
+            runtime = max(runtime, fault_penalty(sys) + sys->granularity);
+            runtime = min(runtime, p->time.remaining);
+            runtime = burst_limit(sys, runtime);
+
+            process_run(sys, runtime);
+            p->vruntime += (long long)runtime * CFS_WEIGHT / p->weight;
+
+            // Check if process has finished
+            if ((p->time.remaining - runtime)) {
+                if (process_pause(sys) == READY) pheap_push(sys->tree, sys->table.context);
+            } else {
+                sys->weight_total -= p->weight;
+                process_finish(sys);
+            }
+
+            cfs_update_min(sys);
+
+            sys->status = READY;
+
+            break;
+
+        default: break;
+    }
+}
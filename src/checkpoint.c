@@ -0,0 +1,464 @@
+/*
+ * checkpoint.c
+ * 
+ * Saving the full state of a running OS to a file, and restoring
+ * it to continue running, possibly with different algorithms.
+ * Written for project 2 of COMP30023 Computer Systems, semester 1
+ * 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "checkpoint.h"
+
+/*
+ * Writes the items of a queue from front to back, after the
+ * number of items.
+ */
+static void write_queue(Queue *q, FILE *file) {
+
+    fwrite(&q->n, sizeof(int), 1, file);
+
+    for (int i = 0; i < q->n; i++) {
+        fwrite(&q->items[(q->head + i) % q->size], sizeof(int), 1, file);
+    }
+}
+
+/*
+ * Reads an array of ints written after its length, exiting if the
+ * file ends early.
+ */
+static int *read_ints(int *n, FILE *file) {
+
+    int *items = NULL;
+
+    if (fread(n, sizeof(int), 1, file) != 1) exit(EXIT_FAILURE);
+
+    items = (int*)malloc(max(*n, 1) * sizeof(int));
+    if (fread(items, sizeof(int), *n, file) != (size_t)*n) exit(EXIT_FAILURE);
+
+    return items;
+}
+
+/*
+ * Reads a block of memory from a file, exiting if the file ends
+ * early.
+ */
+static void read_block(void *ptr, size_t size, size_t n, FILE *file) {
+
+    if (fread(ptr, size, n, file) != n) exit(EXIT_FAILURE);
+}
+
+/*
+ * Writes the full state of an OS to a file. Must only be called
+ * between clock cycles, once evictions have been reported.
+ * 
+ * System *sys:    Pointer to an OS struct.
+ * char *filename: File to write to.
+ */
+void checkpoint(System *sys, char *filename) {
+
+    int flag, none = 0, sizes[4] = { sizeof(System), sizeof(Process), sizeof(Page), sizeof(Frame) };
+    FILE *file;
+
+    if ((file = fopen(filename, "wb")) == NULL) exit(EXIT_FAILURE);
+
+    fwrite(CHECKPOINT_MAGIC, 1, strlen(CHECKPOINT_MAGIC), file);
+    fwrite(sizes, sizeof(int), 4, file);
+
+    // Pointers are written too but are replaced when restored
+    fwrite(sys, sizeof(System), 1, file);
+    fwrite(sys->table.p, sizeof(Process), sys->table.n, file);
+    fwrite(sys->table.states, sizeof(Status), sys->table.n, file);
+    fwrite(sys->pages, sizeof(Page), sys->n_pages, file);
+
+    // Order of ready processes that isn't kept in the process table
+    if (sys->scheduler == RR && sys->batch) {
+        write_queue(sys->fifo, file);
+    } else if (sys->scheduler == MLFQ) {
+
+        flag = 0;
+        for (int i = 0; i < sys->levels; i++) flag += sys->queues[i]->n;
+        fwrite(&flag, sizeof(int), 1, file);
+
+        for (int i = 0; i < sys->levels; i++) {
+            for (int j = 0; j < sys->queues[i]->n; j++) {
+                fwrite(&sys->queues[i]->items[(sys->queues[i]->head + j) % sys->queues[i]->size],
+                       sizeof(int), 1, file);
+            }
+        }
+    } else {
+        fwrite(&none, sizeof(int), 1, file);
+    }
+
+    flag = sys->replacer != NULL;
+    fwrite(&flag, sizeof(int), 1, file);
+
+    if (flag) {
+        fwrite(sys->replacer, sizeof(Replacer), 1, file);
+        fwrite(sys->replacer->frames, sizeof(Frame), 3 * sys->replacer->n, file);
+        fwrite(sys->replacer->spare, sizeof(int), 2 * sys->replacer->n, file);
+    }
+
+    flag = sys->store != NULL;
+    fwrite(&flag, sizeof(int), 1, file);
+
+    if (flag) {
+        fwrite(sys->store, sizeof(Store), 1, file);
+        write_queue(sys->store->queue, file);
+    }
+
+    flag = sys->frag != NULL;
+    fwrite(&flag, sizeof(int), 1, file);
+
+    if (flag) fwrite(sys->frag, sizeof(Frag), 1, file);
+
+    fwrite(sys->stats, sizeof(Stats), 1, file);
+
+    // Parents of each process, by ID, and its bursts
+    for (int i = 0; i < sys->table.n; i++) {
+        fwrite(sys->table.p[i].after, sizeof(int), sys->table.p[i].n_after, file);
+        fwrite(sys->table.p[i].bursts, sizeof(Time), sys->table.p[i].n_bursts, file);
+    }
+
+    fclose(file);
+}
+
+/*
+ * Reads the state of an OS from a checkpoint file. Algorithms and
+ * settings may be changed before it is run, which continues from
+ * where the checkpoint was made.
+ * 
+ * char *filename: File to read from.
+ * Process **p:    Set to the array of Processes for the process table.
+ * 
+ * Returns System*: Pointer to the restored OS struct.
+ */
+System *restore(char *filename, Process **p) {
+
+    int flag, sizes[4] = { sizeof(System), sizeof(Process), sizeof(Page), sizeof(Frame) }, found[4];
+    char magic[sizeof(CHECKPOINT_MAGIC)] = { 0 };
+    System *sys = (System*)calloc(1, sizeof(System));
+    Snapshot *s = (Snapshot*)calloc(1, sizeof(Snapshot));
+    FILE *file;
+
+    if ((file = fopen(filename, "rb")) == NULL) exit(EXIT_FAILURE);
+
+    // Only checkpoints made by the same build can be restored
+    read_block(magic, 1, strlen(CHECKPOINT_MAGIC), file);
+    read_block(found, sizeof(int), 4, file);
+    if (strcmp(magic, CHECKPOINT_MAGIC) || memcmp(sizes, found, sizeof(sizes))) exit(EXIT_FAILURE);
+
+    read_block(sys, sizeof(System), 1, file);
+
+    *p = (Process*)malloc(max(sys->table.n, 1) * sizeof(Process));
+    read_block(*p, sizeof(Process), sys->table.n, file);
+    sys->table.p = *p;
+
+    sys->table.states = (Status*)malloc(max(sys->table.n, 1) * sizeof(Status));
+    read_block(sys->table.states, sizeof(Status), sys->table.n, file);
+
+    sys->pages = (Page*)malloc(max(sys->n_pages, 1) * sizeof(Page));
+    read_block(sys->pages, sizeof(Page), sys->n_pages, file);
+
+    s->scheduler = sys->scheduler;
+    s->allocator = sys->allocator;
+    s->policy = sys->policy;
+
+    // Scheduler state that is reset when the scheduler is set up
+    s->boosted = sys->boosted;
+    s->min_vruntime = sys->min_vruntime;
+    s->weight_total = sys->weight_total;
+    s->order = read_ints(&s->n_order, file);
+
+    read_block(&flag, sizeof(int), 1, file);
+
+    if (flag) {
+        s->replacer = (Replacer*)malloc(sizeof(Replacer));
+        read_block(s->replacer, sizeof(Replacer), 1, file);
+
+        s->replacer->frames = (Frame*)malloc(3 * max(s->replacer->n, 1) * sizeof(Frame));
+        s->replacer->spare = (int*)malloc(2 * max(s->replacer->n, 1) * sizeof(int));
+        s->replacer->heap = NULL;
+        read_block(s->replacer->frames, sizeof(Frame), 3 * s->replacer->n, file);
+        read_block(s->replacer->spare, sizeof(int), 2 * s->replacer->n, file);
+    }
+
+    read_block(&flag, sizeof(int), 1, file);
+
+    if (flag) {
+        s->store = (Store*)malloc(sizeof(Store));
+        read_block(s->store, sizeof(Store), 1, file);
+        s->store->queue = NULL;
+        s->io = read_ints(&s->n_io, file);
+    }
+
+    read_block(&flag, sizeof(int), 1, file);
+
+    if (flag) {
+        s->frag = (Frag*)malloc(sizeof(Frag));
+        read_block(s->frag, sizeof(Frag), 1, file);
+        s->frag->run = s->frag->rank = s->frag->offset = NULL;
+        s->frag->packed = NULL;
+    }
+
+    s->stats = (Stats*)malloc(sizeof(Stats));
+    read_block(s->stats, sizeof(Stats), 1, file);
+
+    for (int i = 0; i < sys->table.n; i++) {
+
+        (*p)[i].after = NULL;
+        (*p)[i].bursts = NULL;
+
+        if ((*p)[i].n_after) {
+            (*p)[i].after = (int*)malloc((*p)[i].n_after * sizeof(int));
+            read_block((*p)[i].after, sizeof(int), (*p)[i].n_after, file);
+        }
+
+        if ((*p)[i].n_bursts) {
+            (*p)[i].bursts = (Time*)malloc((*p)[i].n_bursts * sizeof(Time));
+            read_block((*p)[i].bursts, sizeof(Time), (*p)[i].n_bursts, file);
+        }
+    }
+
+    fclose(file);
+
+    // Algorithm data structures are rebuilt once the OS is run
+    sys->ready = sys->aged = sys->pending = NULL;
+    sys->dag = NULL;
+    sys->waiting = NULL;
+    sys->queues = NULL;
+    sys->tree = NULL;
+    sys->fifo = NULL;
+    sys->evicted = NULL;
+    sys->n_evicted = 0;
+    sys->frames = NULL;
+    sys->arena = NULL;
+    sys->replacer = NULL;
+    sys->store = NULL;
+    sys->frag = NULL;
+    sys->checkpoint = UNDEF;
+    sys->checkpoint_file = NULL;
+    sys->snapshot = s;
+    sys->out = stdout;
+    sys->verifier = NULL;
+    sys->profile = NULL;
+    sys->series = NULL;
+    sys->stats = NULL;
+    sys->online = NULL;
+
+    // Page tables are made once the OS is run, if demand paging
+    for (int i = 0; i < sys->table.n; i++) {
+        (*p)[i].pages = NULL;
+        (*p)[i].ghost = NULL;
+    }
+
+    return sys;
+}
+
+/*
+ * Empties memory without reporting evictions, for when switching
+ * between allocators that don't share a meaning for the pages.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+static void clear_memory(System *sys) {
+
+    for (int i = 0; i < sys->n_pages; i++) {
+        if (sys->pages[i].pid != UNDEF && sys->pages[i].vpn != UNDEF &&
+            sys->table.p[sys->pages[i].pix].pages != NULL) {
+            sys->table.p[sys->pages[i].pix].pages[sys->pages[i].vpn] = NULL;
+        }
+        sys->pages[i].pid = sys->pages[i].pix = sys->pages[i].vpn = UNDEF;
+    }
+
+    for (int i = 0; i < sys->table.n; i++) sys->table.p[i].n_pages = 0;
+
+    sys->n_used = sys->n_resident = 0;
+
+    frames_rebuild(sys);
+}
+
+/*
+ * Restores the replacement state for pages in memory, exactly if
+ * the policy is unchanged or as if newly loaded in address order.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+static void restore_replacer(System *sys) {
+
+    // Shorthand
+    Snapshot *s = sys->snapshot;
+    Replacer *r = sys->replacer;
+    Frame *f = NULL;
+
+    if (s->replacer == NULL || s->policy != sys->policy) {
+        for (int i = 0; i < sys->n_pages; i++) {
+            if (sys->pages[i].pid != UNDEF) replace_insert(sys, i);
+        }
+        return;
+    }
+
+    memmove(r->frames, s->replacer->frames, 3 * r->n * sizeof(Frame));
+    memmove(r->spare, s->replacer->spare, 2 * r->n * sizeof(int));
+    memmove(r->head, s->replacer->head, sizeof(r->head));
+    memmove(r->tail, s->replacer->tail, sizeof(r->tail));
+    memmove(r->size, s->replacer->size, sizeof(r->size));
+
+    r->n_spare = s->replacer->n_spare;
+    r->hand = s->replacer->hand;
+    r->target = s->replacer->target;
+    r->promote = s->replacer->promote;
+
+    for (int i = 0; i < r->n; i++) {
+        if (r->heap != NULL && sys->pages[i].pid != UNDEF) heap_push(r->heap, i);
+    }
+
+    // Ghosts are looked up from the pages of their process
+    for (int g = r->n; g < 3 * r->n; g++) {
+
+        f = &r->frames[g];
+        if (f->list == UNDEF) continue;
+
+        if (sys->table.p[f->pix].ghost == NULL) {
+            int n = max(sys->table.p[f->pix].mem / PAGE_SIZE, 1);
+            sys->table.p[f->pix].ghost = (int*)malloc(n * sizeof(int));
+            for (int i = 0; i < n; i++) sys->table.p[f->pix].ghost[i] = UNDEF;
+        }
+
+        sys->table.p[f->pix].ghost[f->vpn] = g;
+    }
+}
+
+/*
+ * Fills the data structures of algorithms that have just been set
+ * up for a restored OS with the checkpointed state.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void restore_state(System *sys) {
+
+    Heap *order = NULL;
+
+    // Shorthand
+    Snapshot *s = sys->snapshot;
+    Process *p = sys->table.p;
+
+    if (s == NULL) return;
+
+    // Demand paged memory is organised by page rather than by process
+    if ((s->allocator == D) != (sys->allocator == D)) {
+
+        clear_memory(sys);
+
+        if (sys->frag != NULL) {
+            frag_free(sys);
+            frag_init(sys);
+        }
+    }
+
+    if (sys->replacer != NULL) restore_replacer(sys);
+
+    if (sys->store != NULL && s->store != NULL) {
+
+        sys->store->free = s->store->free;
+        sys->store->busy = s->store->busy;
+        sys->store->requests = s->store->requests;
+        sys->store->depth_max = s->store->depth_max;
+        sys->store->depth_total = s->store->depth_total;
+        sys->store->prefetched = s->store->prefetched;
+        sys->store->stalled = s->store->stalled;
+        sys->store->waiting = s->store->waiting;
+
+        for (int i = 0; i < s->n_io; i++) enqueue(sys->store->queue, s->io[i]);
+
+    } else {
+
+        // Without a backing store pages that were loading have arrived
+        for (int i = 0; i < sys->table.n; i++) {
+
+            if (sys->table.states[i] == LOADING) {
+                sys->table.states[i] = p[i].time.started == UNDEF ? START : READY;
+            }
+            p[i].io = UNDEF;
+        }
+    }
+
+    if (sys->frag != NULL && s->frag != NULL) {
+
+        sys->frag->dispatches = s->frag->dispatches;
+        sys->frag->extents = s->frag->extents;
+        sys->frag->extents_max = s->frag->extents_max;
+        sys->frag->passes = s->frag->passes;
+        sys->frag->moved = s->frag->moved;
+        sys->frag->time = s->frag->time;
+        memmove(sys->frag->hist_total, s->frag->hist_total, sizeof(s->frag->hist_total));
+    }
+
+    memmove(sys->stats, s->stats, sizeof(Stats));
+
+    if (sys->scheduler == s->scheduler) {
+        sys->boosted = s->boosted;
+        sys->min_vruntime = s->min_vruntime;
+        sys->weight_total = s->weight_total;
+    }
+
+    // Received processes share the CPU with a different scheduler
+    if (sys->scheduler == CFS && s->scheduler != CFS) {
+
+        sys->weight_total = 0;
+
+        for (int i = 0; i < sys->table.n; i++) {
+            if (sys->table.states[i] != INIT && sys->table.states[i] != TERMINATED) {
+                sys->weight_total += p[i].weight;
+            }
+            p[i].vruntime = 0;
+        }
+
+        sys->min_vruntime = 0;
+    }
+
+    // Levels may have been changed
+    if (sys->scheduler == MLFQ) {
+        for (int i = 0; i < sys->table.n; i++) p[i].level = min(p[i].level, sys->levels - 1);
+    }
+
+    if (sys->scheduler == s->scheduler && s->n_order) {
+
+        // Queued in exactly the order checkpointed
+        for (int i = 0; i < s->n_order; i++) requeue(sys, s->order[i]);
+
+    } else {
+
+        // Otherwise ready processes are queued by time last run
+        order = create_heap((void**)&sys->table.p, sys->table.n, sizeof(Process), compare_last);
+
+        for (int i = 0; i < sys->table.n; i++) {
+            if (sys->table.states[i] == START || sys->table.states[i] == READY) heap_push(order, i);
+        }
+
+        while (order->n) requeue(sys, heap_pop(order));
+
+        free_heap(order);
+    }
+
+    free(s->order);
+    free(s->io);
+    free(s->store);
+    free(s->frag);
+    free(s->stats);
+
+    if (s->replacer != NULL) {
+        free(s->replacer->frames);
+        free(s->replacer->spare);
+        free(s->replacer);
+    }
+
+    free(s);
+    sys->snapshot = NULL;
+}
@@ -0,0 +1,293 @@
+/*
+ * dag.c
+ *
+ * Dependencies between processes, where a process given after=id,...
+ * is held back from arriving until each of those processes has
+ * finished, and a critical path first scheduling algorithm that
+ * runs the process with the longest chain of work waiting on it.
+ * Written for project 2 of COMP30023 Computer Systems, semester 1
+ * 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dag.h"
+
+/*
+ * Process ID and its index in the process table, for looking up
+ * parents by ID.
+ */
+typedef struct Key {
+    int id, i;
+} Key;
+
+/*
+ * qsort comparison function for keys, by ID then index.
+ */
+static int compare_key(const void *a, const void *b) {
+
+    const Key *k1 = a, *k2 = b;
+
+    if (k1->id != k2->id) return k1->id < k2->id ? -1 : 1;
+    return k1->i == k2->i ? 0 : k1->i < k2->i ? -1 : 1;
+}
+
+/*
+ * Finds the index of the first process with an ID, or UNDEF if
+ * there is none.
+ */
+static int find(Key *keys, int n, int id) {
+
+    int low = 0, high = n;
+
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (keys[mid].id < id) low = mid + 1;
+        else high = mid;
+    }
+
+    return low < n && keys[low].id == id ? keys[low].i : UNDEF;
+}
+
+/*
+ * Reads the IDs of the processes a process depends on, given as
+ * a comma separated list.
+ *
+ * Process *p:  Pointer to a process.
+ * char *value: IDs of its parents.
+ */
+void dag_parse(Process *p, char *value) {
+
+    int n = 1;
+    long id;
+    char *end;
+
+    for (char *c = value; *c; c++) n += *c == ',';
+
+    free(p->after);
+    p->after = (int*)malloc(n * sizeof(int));
+    p->n_after = 0;
+
+    // Anything that isn't an ID is skipped
+    while (*value) {
+        id = strtol(value, &end, 10);
+        if (end != value) p->after[p->n_after++] = (int)id;
+        value = *end ? end + 1 : end;
+    }
+
+    if (!p->n_after) {
+        free(p->after);
+        p->after = NULL;
+    }
+}
+
+/*
+ * Finds the critical path through each process, from the last
+ * process in topological order back to the first.
+ */
+static void critical_paths(System *sys, Dag *d, int *order) {
+
+    Time longest;
+
+    // Shorthand
+    Process *p = sys->table.p;
+
+    for (int k = sys->table.n - 1; k >= 0; k--) {
+
+        int i = order[k];
+
+        longest = 0;
+        for (int c = d->start[i]; c < d->start[i + 1]; c++) {
+            longest = max(longest, p[d->children[c]].critical);
+        }
+
+        p[i].critical = p[i].time.job + longest;
+    }
+}
+
+/*
+ * Builds the dependencies between the processes of an OS, if any
+ * process has parents, and finds the critical path through each
+ * process unless it was restored from a checkpoint. Exits if the
+ * dependencies have a cycle.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void dag_init(System *sys) {
+
+    int n = sys->table.n, edges = 0, e = 0, head = 0, tail = 0;
+    int *parent, *next, *indegree, *order;
+    Key *keys;
+    Dag *d;
+
+    // Shorthand
+    Process *p = sys->table.p;
+
+    for (int i = 0; i < n; i++) edges += p[i].n_after;
+
+    // Without dependencies the critical path is the process itself
+    if (!edges) {
+        if (sys->snapshot == NULL) {
+            for (int i = 0; i < n; i++) p[i].critical = p[i].time.job;
+        }
+        return;
+    }
+
+    keys = (Key*)malloc(n * sizeof(Key));
+    for (int i = 0; i < n; i++) keys[i] = (Key){p[i].id, i};
+    qsort(keys, n, sizeof(Key), compare_key);
+
+    d = (Dag*)calloc(1, sizeof(Dag));
+    d->start = (int*)calloc(n + 1, sizeof(int));
+    d->blocked = (int*)calloc(n, sizeof(int));
+    parent = (int*)malloc(edges * sizeof(int));
+
+    // Parents given by an ID no process has are left out
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k < p[i].n_after; k++) {
+            parent[e] = find(keys, n, p[i].after[k]);
+            if (parent[e] != UNDEF) d->start[parent[e] + 1]++;
+            e++;
+        }
+    }
+
+    for (int i = 0; i < n; i++) d->start[i + 1] += d->start[i];
+
+    d->children = (int*)malloc(max(d->start[n], 1) * sizeof(int));
+    next = (int*)malloc(n * sizeof(int));
+    indegree = (int*)calloc(n, sizeof(int));
+    order = (int*)malloc(n * sizeof(int));
+    memmove(next, d->start, n * sizeof(int));
+
+    // Parents that finished before a checkpoint no longer block
+    e = 0;
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k < p[i].n_after; k++, e++) {
+
+            if (parent[e] == UNDEF) continue;
+
+            d->children[next[parent[e]]++] = i;
+            indegree[i]++;
+            if (sys->table.states[parent[e]] != TERMINATED) d->blocked[i]++;
+        }
+    }
+
+    // Topological order, which only misses processes on a cycle
+    for (int i = 0; i < n; i++) {
+        if (!indegree[i]) order[tail++] = i;
+    }
+
+    while (head < tail) {
+        int i = order[head++];
+        for (int c = d->start[i]; c < d->start[i + 1]; c++) {
+            if (!--indegree[d->children[c]]) order[tail++] = d->children[c];
+        }
+    }
+
+    if (tail < n) {
+        for (int i = 0; i < n; i++) {
+            if (indegree[i]) {
+                fprintf(stderr, "Dependency cycle through process %d\n", p[i].id);
+                break;
+            }
+        }
+        exit(EXIT_FAILURE);
+    }
+
+    if (sys->snapshot == NULL) critical_paths(sys, d, order);
+
+    sys->dag = d;
+
+    free(keys);
+    free(parent);
+    free(next);
+    free(indegree);
+    free(order);
+}
+
+/*
+ * Frees the dependencies between the processes of an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void dag_free(System *sys) {
+
+    if (sys->dag == NULL) return;
+
+    free(sys->dag->start);
+    free(sys->dag->children);
+    free(sys->dag->blocked);
+    free(sys->dag);
+
+    sys->dag = NULL;
+}
+
+/*
+ * Frees the parents read for each process.
+ *
+ * Process *p: Array of processes.
+ * int n:      Number of processes.
+ */
+void dag_free_edges(Process *p, int n) {
+
+    for (int i = 0; i < n; i++) {
+        free(p[i].after);
+        p[i].after = NULL;
+    }
+}
+
+/*
+ * Checks if a process is still waiting for a parent to finish.
+ *
+ * System *sys: Pointer to an OS struct.
+ * int i:       Index in the process table of the process.
+ *
+ * Returns int: True if it is blocked, false otherwise.
+ */
+int dag_blocked(System *sys, int i) {
+
+    return sys->dag != NULL && sys->dag->blocked[i] > 0;
+}
+
+/*
+ * Releases the children of a process that has just finished once
+ * none of their parents are left, receiving those that have already
+ * arrived. The others are received when they arrive.
+ *
+ * System *sys: Pointer to an OS struct.
+ * int i:       Index in the process table of the finished process.
+ */
+void dag_finish(System *sys, int i) {
+
+    // Shorthand
+    Dag *d = sys->dag;
+
+    if (d == NULL) return;
+
+    // Only the children are visited, each one counting down its parents
+    for (int c = d->start[i]; c < d->start[i + 1]; c++) {
+
+        int child = d->children[c];
+
+        if (!--d->blocked[child] && child < sys->table.next) arrive(sys, child, sys->time);
+    }
+}
+
+/*
+ * qsort comparison function for the critical path through a process,
+ * longest first and then in order of arrival.
+ */
+int compare_critical(const void *a, const void *b) {
+
+    const Process *p1 = a, *p2 = b;
+
+    if (p1->critical > p2->critical) return -1;
+    if (p1->critical < p2->critical) return 1;
+
+    return compare(a, b);
+}
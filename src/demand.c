@@ -0,0 +1,191 @@
+/*
+ * demand.c
+ * 
+ * Demand paging for virtual memory, where pages are only loaded
+ * when a running process references them. Written for project 2
+ * of COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "demand.h"
+
+/*
+ * Gives every process a page table, allocated together from one
+ * arena, pointing at any of its pages already in memory.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void demand_init(System *sys) {
+
+    size_t total = 0;
+
+    // Shorthand
+    Process *p = sys->table.p;
+
+    // One chunk holds every table, allowing for rounding each up
+    for (int i = 0; i < sys->table.n; i++) {
+        total += max(p[i].mem / PAGE_SIZE, 1) * sizeof(Page*) + ARENA_ALIGN;
+    }
+
+    sys->arena = arena_init(total);
+
+    for (int i = 0; i < sys->table.n; i++) {
+        p[i].pages = (Page**)arena_alloc(sys->arena, max(p[i].mem / PAGE_SIZE, 1) * sizeof(Page*));
+    }
+
+    // Pages restored from a checkpoint
+    for (int i = 0; i < sys->n_pages; i++) {
+        if (sys->pages[i].pid != UNDEF && sys->pages[i].vpn != UNDEF) {
+            p[sys->pages[i].pix].pages[sys->pages[i].vpn] = &sys->pages[i];
+        }
+    }
+}
+
+/*
+ * Frees the page tables of every process at once.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void demand_free(System *sys) {
+
+    if (sys->arena == NULL) return;
+
+    for (int i = 0; i < sys->table.n; i++) sys->table.p[i].pages = NULL;
+
+    arena_free(sys->arena);
+    sys->arena = NULL;
+}
+
+/*
+ * Prepares the process in the current context to run. No pages
+ * are loaded until they are referenced.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void demand(System *sys) {
+
+    // Shorthand
+    Process *p = &sys->table.p[sys->table.context];
+
+    if (!p->rng) p->rng = rng_seed(sys->seed, p->id);
+
+    p->time.load = 0;
+    p->ws = 0;
+}
+
+/*
+ * Chooses the next page a process references.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * Process *p:  Pointer to the running process.
+ * 
+ * Returns int: Index of the page within the process.
+ */
+int next_reference(System *sys, Process *p) {
+
+    int n = max(p->mem / sys->page_size, 1), rank;
+
+    switch (p->access == DEFAULT ? sys->access : p->access) {
+
+        // Walks through its pages in order, wrapping around
+        case SEQUENTIAL: return p->cursor++ % n;
+
+        // Approximates Zipf(1) by drawing log-uniform ranks in [1, n]
+        case ZIPF:
+            rank = (int)pow(n + 1, rng_uniform(&p->rng));
+            return min(rank, n) - 1;
+
+        default: return rng_next(&p->rng) % n;
+    }
+}
+
+/*
+ * Loads a page referenced by the running process that is not
+ * in memory, replacing another page if memory is full.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int vpn:     Index of the page within the process.
+ */
+void fault(System *sys, int vpn) {
+
+    int addr = UNDEF;
+
+    // Shorthand
+    Process *p = &sys->table.p[sys->table.context];
+
+    // No page can be loaded without a frame to load it into
+    if (!sys->n_pages) {
+        fprintf(stderr, "No memory to load a page into\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (sys->n_used < sys->n_pages) {
+        addr = frames_next_free(sys->frames, 0);
+    }
+
+    // Replacement policy chooses a page if there are none free
+    addr = replace_miss(sys, vpn, addr);
+
+    if (sys->pages[addr].pid != UNDEF) {
+
+        int *evicted = (int*)malloc(sizeof(int));
+        evicted[0] = addr;
+
+        page_release(sys, addr);
+        report_evictions(sys, evicted, 1);
+    }
+
+    page_assign(sys, addr, sys->table.context);
+    sys->pages[addr].vpn = vpn;
+    p->pages[vpn] = &sys->pages[addr];
+    replace_insert(sys, addr);
+
+    // Process is stalled while the page loads
+    sys->time += PAGE_LOAD_TIME;
+    p->time.load += PAGE_LOAD_TIME;
+    p->time.fault += PAGE_LOAD_TIME;
+    p->faults++;
+}
+
+/*
+ * Runs the process in the current context, generating page
+ * references from its access model and resolving page faults
+ * as they occur. Each fault stalls the process while the page
+ * is loaded, and pages are replaced by the OS' replacement policy.
+ * 
+ * System *sys:  Pointer to an OS struct.
+ * Time runtime: CPU time to run the process for.
+ */
+void demand_run(System *sys, Time runtime) {
+
+    // Shorthand
+    Process *p = &sys->table.p[sys->table.context];
+
+    for (Time t = 0; t < runtime; t++) {
+        for (int r = 0; r < DEMAND_REFS; r++) {
+
+            int vpn = next_reference(sys, p);
+
+            // Count each page once towards the working set of this run
+            if (p->pages[vpn] == NULL || p->pages[vpn]->used < p->time.last) p->ws++;
+
+            if (p->pages[vpn] == NULL) {
+                fault(sys, vpn);
+            } else {
+                replace_touch(sys, p->pages[vpn] - sys->pages);
+            }
+
+            p->pages[vpn]->used = sys->time;
+        }
+
+        sys->time++;
+    }
+
+    p->ws_max = max(p->ws_max, p->ws);
+}
@@ -0,0 +1,291 @@
+/*
+ * ensemble.c
+ *
+ * Monte Carlo ensembles of an OS, running replicas of it with
+ * randomly perturbed processes in parallel and reporting each
+ * statistic with a confidence interval. Written for project 2 of
+ * COMP30023 Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "ensemble.h"
+
+// Two sided 95% points of Student's t distribution for 1 to 30 degrees of freedom
+static const double t_95[] = {
+    0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+/*
+ * Reads the noise of an ensemble given as job,mem,arrival, where
+ * missing values are left unchanged.
+ *
+ * Noise *noise: Pointer to the noise to set.
+ * char *spec:   Comma separated spreads and arrival jitter.
+ */
+void ensemble_noise(Noise *noise, char *spec) {
+
+    char *end;
+
+    noise->job = strtod(spec, &end);
+    if (*end++ != ',') return;
+
+    noise->mem = strtod(end, &end);
+    if (*end++ != ',') return;
+
+    noise->arrival = strtoll(end, NULL, 10);
+}
+
+/*
+ * Draws a factor with a mean of 1 whose logarithm is normally
+ * distributed with the given standard deviation. A value is drawn
+ * even for no spread so that streams stay aligned.
+ */
+static double spread(uint64_t *rng, double sigma) {
+
+    // Box-Muller transform of two uniform values
+    double u = 1 - rng_uniform(rng), v = rng_uniform(rng);
+    double z = sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+
+    return exp(sigma * z - sigma * sigma / 2);
+}
+
+/*
+ * Copies the processes of the OS an ensemble is based on, with
+ * every process perturbed by its own random number stream.
+ */
+static Process *perturb(Ensemble *e, uint64_t seed) {
+
+    uint64_t rng;
+    Time job, mem, arrived, jitter;
+
+    // Shorthand
+    System *base = e->base;
+    Noise *noise = &e->noise;
+    int n = base->table.n, mem_max = max(base->mem_size / PAGE_SIZE * PAGE_SIZE, PAGE_SIZE);
+
+    Process *p = (Process*)malloc(max(n, 1) * sizeof(Process));
+    memmove(p, base->table.p, n * sizeof(Process));
+
+    for (int i = 0; i < n; i++) {
+
+        rng = rng_seed(seed, p[i].id);
+
+        job = llround(p[i].time.job * spread(&rng, noise->job));
+        p[i].time.job = p[i].time.remaining = max(job, 1);
+
+        mem = ceil_div(llround(p[i].mem * spread(&rng, noise->mem)), PAGE_SIZE) * PAGE_SIZE;
+        if (noise->mem > 0) p[i].mem = (int)min(max(mem, PAGE_SIZE), mem_max);
+
+        jitter = (Time)(rng_uniform(&rng) * (2 * noise->arrival + 1)) - noise->arrival;
+        arrived = p[i].time.arrived + jitter;
+        p[i].time.arrived = max(arrived, 0);
+    }
+
+    return p;
+}
+
+/*
+ * Finds the statistics printed for an OS that has been run.
+ * Averages are not rounded.
+ */
+static void get_metrics(System *sys, double *m) {
+
+    long long faults = 0;
+
+    // Shorthand
+    Stats *s = sys->stats;
+    int n = sys->table.n;
+
+    m[THROUGHPUT_AVG] = s->epochs ? (double)s->tp_total / s->epochs : 0;
+    m[THROUGHPUT_MIN] = s->tp_min;
+    m[THROUGHPUT_MAX] = s->tp_max;
+    m[TURNAROUND] = (double)s->turnaround_total / n;
+    m[OVERHEAD_MAX] = s->overhead_max;
+    m[OVERHEAD_AVG] = s->overhead_total / n;
+    m[MAKESPAN] = s->makespan;
+
+    for (int i = 0; i < n; i++) faults += sys->table.p[i].faults;
+    m[FAULTS] = (double)faults / n;
+
+    m[IO_UTILISATION] = sys->store != NULL && s->makespan ?
+                        (double)sys->store->busy * 100 / s->makespan : 0;
+}
+
+/*
+ * Runs one replica of the OS an ensemble is based on, with its own
+ * processes and random number streams.
+ */
+static void run_replica(Ensemble *e, int r) {
+
+    uint64_t seed = rng_seed(e->base->seed, ENSEMBLE_STREAM + r);
+    System *sys = (System*)malloc(sizeof(System));
+    Process *p = perturb(e, seed);
+
+    // Every setting is copied, but the process table is its own
+    memmove(sys, e->base, sizeof(System));
+    PTable *table = create_table(p, e->base->table.n);
+    memmove(&sys->table, table, sizeof(PTable));
+    free(table);
+
+    sys->seed = seed;
+    sys->out = NULL;
+    sys->checkpoint = UNDEF;
+    sys->checkpoint_file = NULL;
+    sys->verifier = NULL;
+    sys->profile = NULL;
+    sys->series = NULL;
+
+    run(sys);
+    stats_close(sys);
+
+    get_metrics(sys, e->metrics[r]);
+
+    pthread_mutex_lock(&e->lock);
+    sketch_merge(&e->turnaround, &sys->stats->turnaround);
+    sketch_merge(&e->waiting, &sys->stats->waiting);
+    sketch_merge(&e->overhead, &sys->stats->overhead);
+    pthread_mutex_unlock(&e->lock);
+
+    store_free(sys);
+    frag_free(sys);
+    stats_free(sys);
+
+    free(sys->table.states);
+    free(p);
+    free(sys);
+}
+
+/*
+ * Runs replicas of an ensemble until there are none left.
+ */
+static void *worker(void *arg) {
+
+    Ensemble *e = arg;
+    int r;
+
+    while (1) {
+
+        pthread_mutex_lock(&e->lock);
+        r = e->next++;
+        pthread_mutex_unlock(&e->lock);
+
+        if (r >= e->n) return NULL;
+
+        run_replica(e, r);
+    }
+}
+
+/*
+ * Prints the mean of a statistic over every replica, with a 95%
+ * confidence interval from Student's t distribution.
+ */
+static void print_metric(Ensemble *e, Metric metric) {
+
+    double mean = 0, var = 0, half = 0;
+
+    // Shorthand
+    int n = e->n, df = n - 1;
+
+    for (int r = 0; r < n; r++) mean += e->metrics[r][metric];
+    mean /= n;
+
+    for (int r = 0; r < n; r++) var += pow(e->metrics[r][metric] - mean, 2);
+
+    // Past the table the t distribution is close to normal
+    if (df > 0) {
+        var /= df;
+        half = (df < 31 ? t_95[df] : 1.96 + 2.37 / df) * sqrt(var / n);
+    }
+
+    fprintf(e->base->out, "%.2f [%.2f, %.2f]", mean, mean - half, mean + half);
+}
+
+/*
+ * Runs replicas of an OS with perturbed processes, across threads,
+ * and prints the mean of each statistic with a 95% confidence
+ * interval. The OS itself is not run.
+ *
+ * System *sys:  Pointer to an OS struct that has not been run.
+ * int n:        Number of replicas.
+ * Noise noise:  Perturbation of each process.
+ * int threads:  Number of threads, or 0 for one per processor.
+ */
+void ensemble(System *sys, int n, Noise noise, int threads) {
+
+    Ensemble *e = (Ensemble*)calloc(1, sizeof(Ensemble));
+    pthread_t *workers;
+
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    threads = min(max(threads, 1), n);
+
+    e->base = sys;
+    e->noise = noise;
+    e->n = n;
+    e->metrics = calloc(n, sizeof(*e->metrics));
+    pthread_mutex_init(&e->lock, NULL);
+
+    workers = (pthread_t*)malloc(threads * sizeof(pthread_t));
+
+    for (int i = 0; i < threads; i++) pthread_create(&workers[i], NULL, worker, e);
+    for (int i = 0; i < threads; i++) pthread_join(workers[i], NULL);
+
+    fprintf(sys->out, "Replicas %d, noise %.2f, %.2f, %lld\n", n, noise.job, noise.mem, noise.arrival);
+
+    fprintf(sys->out, "Throughput ");
+    print_metric(e, THROUGHPUT_AVG);
+    fprintf(sys->out, ", ");
+    print_metric(e, THROUGHPUT_MIN);
+    fprintf(sys->out, ", ");
+    print_metric(e, THROUGHPUT_MAX);
+
+    fprintf(sys->out, "\nTurnaround time ");
+    print_metric(e, TURNAROUND);
+
+    fprintf(sys->out, "\nTime overhead ");
+    print_metric(e, OVERHEAD_MAX);
+    fprintf(sys->out, " ");
+    print_metric(e, OVERHEAD_AVG);
+
+    fprintf(sys->out, "\nMakespan ");
+    print_metric(e, MAKESPAN);
+    fprintf(sys->out, "\n");
+
+    if (sys->allocator == D) {
+        fprintf(sys->out, "Page faults ");
+        print_metric(e, FAULTS);
+        fprintf(sys->out, "\n");
+    }
+
+    if (sys->bandwidth > 0 && sys->allocator != U && sys->allocator != D) {
+        fprintf(sys->out, "I/O utilisation ");
+        print_metric(e, IO_UTILISATION);
+        fprintf(sys->out, "\n");
+    }
+
+    // Distributions are pooled over every replica
+    if (sys->percentiles) {
+        fprintf(sys->out, "Turnaround time p50 %lld, p95 %lld, p99 %lld\n",
+                sketch_quantile(&e->turnaround, 0.5), sketch_quantile(&e->turnaround, 0.95),
+                sketch_quantile(&e->turnaround, 0.99));
+        fprintf(sys->out, "Waiting time p50 %lld, p95 %lld, p99 %lld\n",
+                sketch_quantile(&e->waiting, 0.5), sketch_quantile(&e->waiting, 0.95),
+                sketch_quantile(&e->waiting, 0.99));
+        fprintf(sys->out, "Time overhead p50 %.2f, p95 %.2f, p99 %.2f\n",
+                sketch_quantile(&e->overhead, 0.5) / 100.0, sketch_quantile(&e->overhead, 0.95) / 100.0,
+                sketch_quantile(&e->overhead, 0.99) / 100.0);
+    }
+
+    pthread_mutex_destroy(&e->lock);
+    free(workers);
+    free(e->metrics);
+    free(e);
+}
@@ -22,11 +22,11 @@
 Status ff_context(System *sys) {
     
     // Shorthand
-    Process *p = sys->table.p;
+    Status *s = sys->table.states;
 
     // Set context to be the next immediately available process
     for (int i = 0; i < sys->table.n; i++) {
-        if (p[i].status == START || p[i].status == READY) {
+        if (s[i] == START || s[i] == READY) {
             sys->table.context = i;
             return READY;
         }
@@ -44,18 +44,22 @@ Status ff_context(System *sys) {
  */
 void ff_step(System *sys) {
 
+    Time runtime;
+    Process *p = NULL;
+
     switch (sys->status) {
 
         // New process
         case READY:
 
             // Update current context, or stop running if no processes available
-            if (ff_context(sys) == TERMINATED) {
+            if (profile_context(sys, ff_context) == TERMINATED) {
                 sys->status = TERMINATED;
                 break;
             } 
 
-            process_start(sys);
+            // Dispatch another process while its pages load
+            if (process_start(sys) == LOADING) break;
 
             sys->status = RUNNING;
 
@@ -63,10 +67,19 @@ void ff_step(System *sys) {
         
         case RUNNING:
 
-            // Only one process will run at a time during FF scheduling
-            sys->time += sys->table.p[sys->table.context].time.job;
+            // Shorthand
+            p = &sys->table.p[sys->table.context];
+
+            // Only one process will run at a time during FF scheduling, until it finishes or blocks
+            runtime = burst_limit(sys, p->time.remaining);
+            process_run(sys, runtime);
 
-            process_finish(sys);
+            // Other processes run while it waits for I/O
+            if (p->time.remaining - runtime) {
+                process_pause(sys);
+            } else {
+                process_finish(sys);
+            }
 
             sys->status = READY;
 
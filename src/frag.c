@@ -0,0 +1,288 @@
+/*
+ * frag.c
+ * 
+ * Memory fragmentation metrics, tracked as pages are allocated
+ * and freed, and a compaction pass that relocates pages so every
+ * process is contiguous. Written for project 2 of COMP30023
+ * Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "frag.h"
+
+/*
+ * Finds the histogram bucket for a free run, by the power of
+ * two at or below its length.
+ */
+static int bucket(int len) {
+
+    int b = 0;
+
+    while (len >>= 1) b++;
+
+    return min(b, FRAG_BUCKETS - 1);
+}
+
+/*
+ * Checks if a memory address is within memory and free.
+ */
+static int is_free(System *sys, int addr) {
+
+    return addr >= 0 && addr < sys->n_pages && sys->pages[addr].pid == UNDEF;
+}
+
+/*
+ * Checks if a memory address is within memory and allocated to
+ * a process.
+ */
+static int is_owned(System *sys, int addr, int pix) {
+
+    return addr >= 0 && addr < sys->n_pages &&
+           sys->pages[addr].pid != UNDEF && sys->pages[addr].pix == pix;
+}
+
+/*
+ * Records a run of free pages, if it is not empty.
+ */
+static void run_add(Frag *f, int start, int len) {
+
+    if (len <= 0) return;
+
+    f->run[start] = f->run[start + len - 1] = len;
+    f->hist[bucket(len)]++;
+}
+
+/*
+ * Recounts every free run and process extent from scratch.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+static void rebuild(System *sys) {
+
+    int start, addr = 0;
+
+    // Shorthand
+    Frag *f = sys->frag;
+    Page *pages = sys->pages;
+
+    memset(f->hist, 0, sizeof(f->hist));
+    for (int i = 0; i < sys->table.n; i++) sys->table.p[i].extents = 0;
+
+    while (addr < sys->n_pages) {
+
+        if (pages[addr].pid == UNDEF) {
+
+            for (start = addr; is_free(sys, addr); addr++);
+            run_add(f, start, addr - start);
+
+        } else {
+
+            // New extent unless it continues on from the page before
+            if (!is_owned(sys, addr - 1, pages[addr].pix)) sys->table.p[pages[addr].pix].extents++;
+            addr++;
+        }
+    }
+}
+
+/*
+ * Allocates fragmentation tracking for the memory of an OS.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void frag_init(System *sys) {
+
+    Frag *f = (Frag*)calloc(1, sizeof(Frag));
+
+    f->run = (int*)calloc(1, max(sys->n_pages, 1) * sizeof(int));
+    f->rank = (int*)malloc(max(sys->table.n, 1) * sizeof(int));
+    f->offset = (int*)malloc(max(sys->n_pages, 1) * sizeof(int));
+    f->packed = (Page*)malloc(max(sys->n_pages, 1) * sizeof(Page));
+
+    for (int i = 0; i < sys->table.n; i++) f->rank[i] = UNDEF;
+
+    // Relocating pages would lose the state of the page replacement policy
+    f->cost = sys->allocator == D ? UNDEF : sys->compaction;
+
+    sys->frag = f;
+
+    rebuild(sys);
+}
+
+/*
+ * Frees the fragmentation tracking of an OS.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void frag_free(System *sys) {
+
+    Frag *f = sys->frag;
+
+    if (f == NULL) return;
+
+    free(f->run);
+    free(f->rank);
+    free(f->offset);
+    free(f->packed);
+    free(f);
+
+    sys->frag = NULL;
+}
+
+/*
+ * Updates fragmentation after a free page has been allocated.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ */
+void frag_assign(System *sys, int addr) {
+
+    int start = addr, len, pix = sys->pages[addr].pix;
+
+    // Shorthand
+    Frag *f = sys->frag;
+
+    if (f == NULL) return;
+
+    // Pages are allocated first fit so this is almost always the start of the run
+    while (is_free(sys, start - 1)) start--;
+
+    len = f->run[start];
+    f->hist[bucket(len)]--;
+
+    // Split the run either side of the page
+    run_add(f, start, addr - start);
+    run_add(f, addr + 1, start + len - addr - 1);
+
+    sys->table.p[pix].extents += 1 - is_owned(sys, addr - 1, pix) - is_owned(sys, addr + 1, pix);
+}
+
+/*
+ * Updates fragmentation for a page about to be freed.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ */
+void frag_release(System *sys, int addr) {
+
+    int start = addr, end = addr, pix = sys->pages[addr].pix;
+
+    // Shorthand
+    Frag *f = sys->frag;
+
+    if (f == NULL) return;
+
+    sys->table.p[pix].extents -= 1 - is_owned(sys, addr - 1, pix) - is_owned(sys, addr + 1, pix);
+
+    // Merge with the free runs either side
+    if (is_free(sys, addr - 1)) {
+        start = addr - f->run[addr - 1];
+        f->hist[bucket(f->run[addr - 1])]--;
+    }
+
+    if (is_free(sys, addr + 1)) {
+        end = addr + f->run[addr + 1];
+        f->hist[bucket(f->run[addr + 1])]--;
+    }
+
+    run_add(f, start, end - start + 1);
+}
+
+/*
+ * Records the fragmentation of memory as the process in the
+ * current context is dispatched.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void frag_sample(System *sys) {
+
+    // Shorthand
+    Frag *f = sys->frag;
+    Process *p = &sys->table.p[sys->table.context];
+
+    if (f == NULL) return;
+
+    f->dispatches++;
+    f->extents += p->extents;
+    f->extents_max = max(f->extents_max, p->extents);
+
+    for (int b = 0; b < FRAG_BUCKETS; b++) f->hist_total[b] += f->hist[b];
+}
+
+/*
+ * Relocates pages so that every process is contiguous and all free
+ * memory is one run at the end, if the process in the current
+ * context is not already contiguous. The time taken is added to
+ * the load time of the process.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void compact(System *sys) {
+
+    int groups = 0, moved = 0, used = 0, dest, n;
+
+    // Shorthand
+    Frag *f = sys->frag;
+    Page *pages = sys->pages;
+    Process *p = &sys->table.p[sys->table.context];
+
+    if (f == NULL || f->cost == UNDEF || p->extents <= 1) return;
+
+    // Processes keep the order of their lowest page
+    for (int addr = 0; addr < sys->n_pages; addr++) {
+
+        if (pages[addr].pid == UNDEF) continue;
+
+        if (f->rank[pages[addr].pix] == UNDEF) {
+            f->rank[pages[addr].pix] = groups;
+            f->offset[groups++] = 0;
+        }
+
+        f->offset[f->rank[pages[addr].pix]]++;
+    }
+
+    // First address of each process
+    for (int g = 0; g < groups; g++) {
+        n = f->offset[g];
+        f->offset[g] = used;
+        used += n;
+    }
+
+    for (int addr = 0; addr < sys->n_pages; addr++) {
+
+        if (pages[addr].pid == UNDEF) continue;
+
+        dest = f->offset[f->rank[pages[addr].pix]]++;
+        f->packed[dest] = pages[addr];
+        moved += dest != addr;
+    }
+
+    for (int addr = used; addr < sys->n_pages; addr++) {
+        f->packed[addr].pid = f->packed[addr].pix = f->packed[addr].vpn = UNDEF;
+        f->packed[addr].used = 0;
+    }
+
+    memmove(pages, f->packed, sys->n_pages * sizeof(Page));
+    frames_rebuild(sys);
+
+    // Point page tables at the new addresses
+    for (int addr = 0; addr < used; addr++) {
+
+        f->rank[pages[addr].pix] = UNDEF;
+
+        if (pages[addr].vpn != UNDEF) {
+            sys->table.p[pages[addr].pix].pages[pages[addr].vpn] = &pages[addr];
+        }
+    }
+
+    rebuild(sys);
+
+    f->passes++;
+    f->moved += moved;
+    f->time += moved * f->cost;
+    p->time.load += moved * f->cost;
+}
@@ -0,0 +1,190 @@
+/*
+ * frames.c
+ *
+ * A compact map of which process owns each memory page, kept
+ * alongside the pages so that scans over all of memory read 4
+ * bytes or 1 bit a page rather than a whole Page. Searches use
+ * vector instructions where the build has them. Written for
+ * project 2 of COMP30023 Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "frames.h"
+
+/*
+ * Builds the owner map for the memory of an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void frames_init(System *sys) {
+
+    Frames *f = (Frames*)calloc(1, sizeof(Frames));
+
+    f->n = sys->n_pages;
+    f->words = (f->n + 63) / 64;
+    f->owner = (int32_t*)malloc((f->n + FRAMES_PAD) * sizeof(int32_t));
+    f->occupied = (uint64_t*)malloc(max(f->words, 1) * sizeof(uint64_t));
+
+    sys->frames = f;
+
+    frames_rebuild(sys);
+}
+
+/*
+ * Frees the owner map of an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void frames_free(System *sys) {
+
+    if (sys->frames == NULL) return;
+
+    free(sys->frames->owner);
+    free(sys->frames->occupied);
+    free(sys->frames);
+
+    sys->frames = NULL;
+}
+
+/*
+ * Rebuilds the owner map after pages were changed all at once.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void frames_rebuild(System *sys) {
+
+    // Shorthand
+    Frames *f = sys->frames;
+
+    // Every byte of UNDEF is 0xff
+    memset(f->owner, 0xff, (f->n + FRAMES_PAD) * sizeof(int32_t));
+    memset(f->occupied, 0, max(f->words, 1) * sizeof(uint64_t));
+
+    for (int addr = 0; addr < f->n; addr++) {
+        if (sys->pages[addr].pid != UNDEF) frames_assign(sys, addr, sys->pages[addr].pix);
+    }
+}
+
+/*
+ * Records that a page has been allocated.
+ *
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ * int pix:     Index in the process table of the process.
+ */
+void frames_assign(System *sys, int addr, int pix) {
+
+    sys->frames->owner[addr] = pix;
+    sys->frames->occupied[addr / 64] |= (uint64_t)1 << (addr % 64);
+}
+
+/*
+ * Records that a page has been freed.
+ *
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ */
+void frames_release(System *sys, int addr) {
+
+    sys->frames->owner[addr] = UNDEF;
+    sys->frames->occupied[addr / 64] &= ~((uint64_t)1 << (addr % 64));
+}
+
+/*
+ * Finds the first set bit at or after a bit in a bitmap, which is
+ * inverted first if searching for a clear bit.
+ */
+static int next_bit(Frames *f, int from, uint64_t invert) {
+
+    int w = from / 64;
+    uint64_t word;
+
+    if (from >= f->n) return UNDEF;
+
+    // Ignore bits before the start in the first word
+    word = (f->occupied[w] ^ invert) & (~(uint64_t)0 << (from % 64));
+
+    while (!word) {
+        if (++w >= f->words) return UNDEF;
+        word = f->occupied[w] ^ invert;
+    }
+
+    from = w * 64 + __builtin_ctzll(word);
+
+    // Bits after the last page are clear, so may be found inverted
+    return from < f->n ? from : UNDEF;
+}
+
+/*
+ * Finds the first free page at or after an address.
+ *
+ * Frames *f: Pointer to an owner map.
+ * int from:  Memory address to start from.
+ *
+ * Returns int: Memory address of the page, or UNDEF if there is none.
+ */
+int frames_next_free(Frames *f, int from) {
+
+    return next_bit(f, from, ~(uint64_t)0);
+}
+
+/*
+ * Finds the first allocated page at or after an address.
+ *
+ * Frames *f: Pointer to an owner map.
+ * int from:  Memory address to start from.
+ *
+ * Returns int: Memory address of the page, or UNDEF if there is none.
+ */
+int frames_next_used(Frames *f, int from) {
+
+    return next_bit(f, from, 0);
+}
+
+/*
+ * Finds the first page allocated to a process at or after an address.
+ *
+ * Frames *f: Pointer to an owner map.
+ * int pix:   Index in the process table of the process.
+ * int from:  Memory address to start from.
+ *
+ * Returns int: Memory address of the page, or UNDEF if there is none.
+ */
+int frames_next_owned(Frames *f, int pix, int from) {
+
+    int addr = max(from, 0), mask = 0;
+
+    // Padding after the last page is free, so loads past the end never match
+#if defined(__AVX2__)
+    __m256i key = _mm256_set1_epi32(pix);
+
+    for (; addr < f->n; addr += FRAMES_LANES) {
+        __m256i slots = _mm256_loadu_si256((const __m256i*)(f->owner + addr));
+        mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(slots, key)));
+        if (mask) break;
+    }
+#elif defined(__SSE2__)
+    __m128i key = _mm_set1_epi32(pix);
+
+    for (; addr < f->n; addr += FRAMES_LANES) {
+        __m128i slots = _mm_loadu_si128((const __m128i*)(f->owner + addr));
+        mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(slots, key)));
+        if (mask) break;
+    }
+#else
+    for (; addr < f->n; addr++) {
+        if ((mask = f->owner[addr] == pix)) break;
+    }
+#endif
+
+    if (!mask) return UNDEF;
+
+    addr += __builtin_ctz(mask);
+
+    return addr < f->n ? addr : UNDEF;
+}
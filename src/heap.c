@@ -0,0 +1,195 @@
+/*
+ * heap.c
+ * 
+ * An indexed binary min-heap of process table indices, ordered
+ * by a qsort style comparison of the processes, for use by the
+ * scheduling algorithms. Written for project 2 of COMP30023
+ * Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+
+#include "heap.h"
+
+/*
+ * Compares the records at two positions in the heap.
+ */
+static int less(Heap *h, int a, int b) {
+
+    char *base = *h->base;
+
+    return h->compare(base + h->items[a] * h->width,
+                      base + h->items[b] * h->width) < 0;
+}
+
+/*
+ * Exchanges the indices at two positions in the heap.
+ */
+static void exchange(Heap *h, int a, int b) {
+
+    int tmp = h->items[a];
+
+    h->items[a] = h->items[b];
+    h->items[b] = tmp;
+
+    h->pos[h->items[a]] = a;
+    h->pos[h->items[b]] = b;
+}
+
+/*
+ * Moves the index at a position towards the root until in heap order.
+ */
+static void sift_up(Heap *h, int k) {
+
+    while (k > 0 && less(h, k, (k - 1) / 2)) {
+        exchange(h, k, (k - 1) / 2);
+        k = (k - 1) / 2;
+    }
+}
+
+/*
+ * Moves the index at a position towards the leaves until in heap order.
+ */
+static void sift_down(Heap *h, int k) {
+
+    int child;
+
+    while ((child = 2 * k + 1) < h->n) {
+
+        // Pick the smaller of the two children
+        if (child + 1 < h->n && less(h, child + 1, child)) child++;
+
+        if (!less(h, child, k)) break;
+
+        exchange(h, k, child);
+        k = child;
+    }
+}
+
+/*
+ * Allocates memory for a new, empty heap.
+ * 
+ * void **base:    Pointer to the array of records that will be indexed.
+ * int size:       Number of records in the array.
+ * size_t width:   Size in bytes of each record.
+ * int (*compare): qsort style comparison function for two records.
+ * 
+ * Returns Heap*: Pointer to the new Heap struct.
+ */
+Heap *create_heap(void **base, int size, size_t width,
+                  int (*compare)(const void *, const void *)) {
+
+    Heap *h = (Heap*)calloc(1, sizeof(Heap));
+
+    h->size = size > 0 ? size : 1;
+    h->items = (int*)malloc(h->size * sizeof(int));
+    h->pos = (int*)malloc(h->size * sizeof(int));
+    h->n = 0;
+    h->base = base;
+    h->width = width;
+    h->compare = compare;
+
+    for (int i = 0; i < h->size; i++) h->pos[i] = -1;
+
+    return h;
+}
+
+/*
+ * Frees a heap and its arrays.
+ * 
+ * Heap *h: Pointer to a heap.
+ */
+void free_heap(Heap *h) {
+
+    if (h == NULL) return;
+
+    free(h->items);
+    free(h->pos);
+    free(h);
+}
+
+/*
+ * Adds a record index to a heap, growing it if the index is past
+ * the records it was made for.
+ * 
+ * Heap *h: Pointer to a heap.
+ * int i:   Index of the record to add.
+ */
+void heap_push(Heap *h, int i) {
+
+    if (i >= h->size) {
+
+        // Records may be added to the array while it is indexed
+        int size = 2 * h->size > i ? 2 * h->size : i + 1;
+
+        h->items = (int*)realloc(h->items, size * sizeof(int));
+        h->pos = (int*)realloc(h->pos, size * sizeof(int));
+        for (int j = h->size; j < size; j++) h->pos[j] = -1;
+        h->size = size;
+    }
+
+    h->items[h->n] = i;
+    h->pos[i] = h->n;
+    h->n++;
+
+    sift_up(h, h->n - 1);
+}
+
+/*
+ * Removes the index of the smallest record from a heap.
+ * 
+ * Heap *h: Pointer to a non-empty heap.
+ * 
+ * Returns int: Index of the smallest record.
+ */
+int heap_pop(Heap *h) {
+
+    int i = h->items[0];
+
+    heap_remove(h, i);
+
+    return i;
+}
+
+/*
+ * Restores heap order after the key of a record has changed.
+ * Does nothing if the record is not in the heap.
+ * 
+ * Heap *h: Pointer to a heap.
+ * int i:   Index of the changed record.
+ */
+void heap_update(Heap *h, int i) {
+
+    if (h->pos[i] < 0) return;
+
+    sift_up(h, h->pos[i]);
+    sift_down(h, h->pos[i]);
+}
+
+/*
+ * Removes a record index from anywhere within a heap. Does
+ * nothing if the record is not in the heap.
+ * 
+ * Heap *h: Pointer to a heap.
+ * int i:   Index of the record to remove.
+ */
+void heap_remove(Heap *h, int i) {
+
+    int k = h->pos[i], last;
+
+    if (k < 0) return;
+
+    // Fill the hole with the last index and restore heap order around it
+    h->n--;
+    if (k != h->n) {
+        last = h->items[h->n];
+        exchange(h, k, h->n);
+        sift_up(h, k);
+        sift_down(h, h->pos[last]);
+    }
+
+    h->pos[i] = -1;
+}
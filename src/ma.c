@@ -0,0 +1,156 @@
+/*
+ * ma.c
+ * 
+ * A memory-aware process scheduling algorithm, which prefers to
+ * run processes with the most pages already in memory, to run for
+ * a process scheduling simulator. Written for project 2 of
+ * COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include "ma.h"
+
+/*
+ * qsort comparison function for the number of pages a process
+ * is missing from memory, then time last run.
+ */
+int compare_missing(const void *a, const void *b) {
+
+    const Process *p1 = a, *p2 = b;
+    int m1 = p1->mem / PAGE_SIZE - p1->n_pages, m2 = p2->mem / PAGE_SIZE - p2->n_pages;
+
+    if (m1 < m2) return -1;
+    if (m1 == m2) return compare_last(a, b);
+    return 1;
+}
+
+/*
+ * Allocates the indices of received processes by missing
+ * pages and by time last run.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void ma_init(System *sys) {
+
+    sys->ready = create_heap((void**)&sys->table.p, sys->table.n,
+                             sizeof(Process), compare_missing);
+    sys->aged = create_heap((void**)&sys->table.p, sys->table.n,
+                            sizeof(Process), compare_last);
+}
+
+/*
+ * Frees the indices of received processes.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void ma_free(System *sys) {
+
+    free_heap(sys->aged);
+    sys->aged = NULL;
+}
+
+/*
+ * Receives a process ready to be run into both indices.
+ * 
+ * System *sys: Pointer to the OS.
+ * int i:       Index in the process table of the process.
+ */
+void ma_admit(System *sys, int i) {
+
+    heap_push(sys->ready, i);
+    heap_push(sys->aged, i);
+}
+
+/*
+ * Updates the current context to be the process missing the
+ * fewest pages, unless a process has waited longer than the
+ * aging limit in which case the longest waiting one is chosen.
+ * 
+ * System *sys: Pointer to an OS.
+ * 
+ * returns Status: Enumerated status flag.
+ */
+Status ma_context(System *sys) {
+
+    int oldest;
+
+    // No valid process found
+    if (!sys->ready->n) return TERMINATED;
+
+    oldest = sys->aged->items[0];
+
+    if (sys->time - sys->table.p[oldest].time.last >= sys->aging) {
+        sys->table.context = oldest;
+    } else {
+        sys->table.context = sys->ready->items[0];
+    }
+
+    heap_remove(sys->ready, sys->table.context);
+    heap_remove(sys->aged, sys->table.context);
+
+    return READY;
+}
+
+/*
+ * Handles a clock cycle for the OS according to
+ * memory-aware scheduling.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void ma_step(System *sys) {
+
+    Time runtime;
+    Process *p = NULL;
+    Status dispatched;
+
+    switch (sys->status) {
+
+        // New process
+        case READY:
+
+            // Update current context, or stop running if no processes available
+            if (profile_context(sys, ma_context) == TERMINATED) {
+                sys->status = TERMINATED;
+                break;
+            }
+
+            if (sys->table.states[sys->table.context] == START) {
+                dispatched = process_start(sys);
+            } else {
+                dispatched = process_resume(sys);
+            }
+
+            // Dispatch another process while its pages load
+            if (dispatched == LOADING) break;
+
+            sys->status = RUNNING;
+
+            break;
+
+        case RUNNING:
+
+            // Shorthand
+            p = &sys->table.p[sys->table.context];
+
+            // Run only for quantum time limit or time remaining, or until it blocks
+            runtime = min(sys->quantum, p->time.remaining);
+            runtime = burst_limit(sys, runtime);
+
+            process_run(sys, runtime);
+
+            // Check if process has finished
+            if ((p->time.remaining - runtime)) {
+                if (process_pause(sys) == READY) ma_admit(sys, sys->table.context);
+            } else {
+                process_finish(sys);
+            }
+
+            sys->status = READY;
+
+            break;
+
+        default: break;
+    }
+}
@@ -44,12 +44,63 @@ Page *create_memory(int size, int page_size) {
     Page *m = (Page*)calloc(1, (size / page_size) * sizeof(Page));
 
     for (int i = 0; i < (size / page_size); i++) {
-        m[i].pid = m[i].pix = UNDEF;
+        m[i].pid = m[i].pix = m[i].vpn = UNDEF;
     }
 
     return m;
 }
 
+/*
+ * Allocates a free memory page to a process.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of a free page.
+ * int pix:     Index in the process table of the process.
+ */
+void page_assign(System *sys, int addr, int pix) {
+
+    sys->pages[addr].pid = sys->table.p[pix].id;
+    sys->pages[addr].pix = pix;
+    sys->pages[addr].vpn = UNDEF;
+    sys->pages[addr].used = sys->time;
+    frames_assign(sys, addr, pix);
+
+    if (++sys->table.p[pix].n_pages == 1) sys->n_resident++;
+    sys->n_used++;
+
+    PROFILE_COUNT(sys, ALLOCATED, 1);
+
+    frag_assign(sys, addr);
+
+    residency_changed(sys, pix);
+}
+
+/*
+ * Frees a memory page, removing it from the page table of
+ * the process it was allocated to.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of an allocated page.
+ */
+void page_release(System *sys, int addr) {
+
+    // Shorthand
+    Page *page = &sys->pages[addr];
+    Process *p = &sys->table.p[page->pix];
+
+    if (page->vpn != UNDEF) p->pages[page->vpn] = NULL;
+    if (sys->replacer != NULL) replace_remove(sys, addr);
+    frag_release(sys, addr);
+    frames_release(sys, addr);
+
+    if (--p->n_pages == 0) sys->n_resident--;
+    sys->n_used--;
+
+    residency_changed(sys, page->pix);
+
+    page->pid = page->pix = page->vpn = UNDEF;
+}
+
 /*
  * Allocates pages to the process in the current context.
  * Only allocates pages that are free, does not create
@@ -60,46 +111,76 @@ Page *create_memory(int size, int page_size) {
  */
 void allocate(System *sys, int target) {
 
+    int addr = 0, next;
+
     // Shorthand
     Process *p = &sys->table.p[sys->table.context];
 
-    for (int i = 0; (p->n_pages < target) && (i < sys->n_pages); i++) {
-        if (sys->pages[i].pid == UNDEF) {
+    while (p->n_pages < target && (next = frames_next_free(sys->frames, addr)) != UNDEF) {
 
-            // Update OS struct to reflect changes
-            sys->pages[i].pid = p->id;
-            sys->pages[i].pix = sys->table.context;
-            p->n_pages++;
-            p->time.load += PAGE_LOAD_TIME;
-        }
+        PROFILE_COUNT(sys, SCANNED, next - addr + 1);
+
+        // Update OS struct to reflect changes
+        page_assign(sys, next, sys->table.context);
+        p->time.load += PAGE_LOAD_TIME;
+
+        addr = next + 1;
     }
 }
 
+/*
+ * Notifies of evicted pages, or holds onto them to be reported
+ * together with any other evictions at the same time if batching.
+ * 
+ * System *sys:  Pointer to an OS struct.
+ * int *evicted: malloc'd array of evicted memory addresses.
+ * int n:        Number of evicted addresses.
+ */
+void report_evictions(System *sys, int *evicted, int n) {
+
+    PROFILE_COUNT(sys, EVICTED, n);
+
+    if (!sys->batch) {
+        notify(EVICT, *sys, 2, evicted, n);
+        return;
+    }
+
+    sys->evicted = (int*)realloc(sys->evicted, (sys->n_evicted + n) * sizeof(int));
+    memmove(sys->evicted + sys->n_evicted, evicted, n * sizeof(int));
+    sys->n_evicted += n;
+
+    free(evicted);
+}
+
 /*
  * Evicts pages currently allocated to a process.
  * 
  * System *sys: Pointer to an OS struct.
- * int pid:     Process ID to evict pages for.
+ * int pix:     Index in the process table of the process to evict pages for.
  * int n:       Number of pages to evict.
  */
-void evict_process(System *sys, int pid, int n) {
+void evict_process(System *sys, int pix, int n) {
 
     // Track successfully evicted pages
-    int n_evicted = 0, *evicted = (int*)calloc(1, n * sizeof(int));
+    int n_evicted = 0, *evicted = (int*)calloc(1, n * sizeof(int)), addr = 0, next;
 
-    for (int i = 0; i < sys->n_pages && (n_evicted < n); i++) {
-        if (sys->pages[i].pid == pid) {
+    PROFILE_START(sys, EVICTION);
 
-            // Update OS struct to reflect changes
-            sys->table.p[sys->pages[i].pix].n_pages--;
-            sys->pages[i].pid = UNDEF;
-            sys->pages[i].pix = UNDEF;
-            evicted[n_evicted] = i;
-            n_evicted++;
-        }
+    while (n_evicted < n && (next = frames_next_owned(sys->frames, pix, addr)) != UNDEF) {
+
+        PROFILE_COUNT(sys, SCANNED, next - addr + 1);
+
+        // Update OS struct to reflect changes
+        page_release(sys, next);
+        evicted[n_evicted] = next;
+        n_evicted++;
+
+        addr = next + 1;
     }
 
-    notify(EVICT, *sys, 2, evicted, n_evicted);
+    report_evictions(sys, evicted, n_evicted);
+
+    PROFILE_STOP(sys, EVICTION);
 }
 
 /*
@@ -113,22 +194,40 @@ void evict_pages(System *sys, int *pages, int n) {
 
     // Track successfully evicted pages
     int n_evicted = 0, *evicted = (int*)calloc(1, n * sizeof(int));
-    Page *page = NULL;
 
-    for (int i = 0; i < n; i++) {
+    PROFILE_START(sys, EVICTION);
 
-        // Current page in loop
-        page = &sys->pages[pages[i]];
+    for (int i = 0; i < n; i++) {
 
         // Update OS struct to reflect changes
-        sys->table.p[page->pix].n_pages--;
-        page->pid = UNDEF;
-        page->pix = UNDEF;
+        page_release(sys, pages[i]);
         evicted[n_evicted] = pages[i];
         n_evicted++;
     }
 
-    notify(EVICT, *sys, 2, evicted, n_evicted);
+    report_evictions(sys, evicted, n_evicted);
+
+    PROFILE_STOP(sys, EVICTION);
+}
+
+/*
+ * Reports the pages evicted so far at the current time as a
+ * single eviction, if evictions are being batched.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void flush_evictions(System *sys) {
+
+    if (!sys->n_evicted) return;
+
+    // Notification frees the array it is given
+    int *evicted = (int*)malloc(sys->n_evicted * sizeof(int));
+    memmove(evicted, sys->evicted, sys->n_evicted * sizeof(int));
+    qsort(evicted, sys->n_evicted, sizeof(int), compare_int);
+
+    notify(EVICT, *sys, 2, evicted, sys->n_evicted);
+
+    sys->n_evicted = 0;
 }
 
 /*
@@ -143,19 +242,26 @@ int oldest(System sys) {
 
     // Shorthand
     Process *p = sys.table.p;
+    Status *s = sys.table.states;
 
     int candidate = UNDEF;
 
     // Set context to be the least recently executed or received process
     for (int i = 0; i < sys.table.n; i++) {
 
-        if (candidate == UNDEF && p[i].n_pages && p[i].status != LOADING) {
+        // Only processes that have arrived and not finished can have pages
+        if (s[i] == INIT || s[i] == TERMINATED) continue;
+
+        // Pages being loaded from the backing store must stay
+        if (pinned(&sys, i)) continue;
+
+        if (candidate == UNDEF && s[i] != LOADING && p[i].n_pages) {
             candidate = i;
             continue;
         }
 
-        // If this candidate is current and has pages allocated
-        if ((p[i].status == START || p[i].status == READY) && p[i].n_pages) {
+        // If this candidate is current and has pages allocated, or is blocked
+        if ((s[i] == START || s[i] == READY || s[i] == BLOCKED) && p[i].n_pages) {
             
             if (p[i].time.last < p[candidate].time.last) {
                 candidate = i;
@@ -181,10 +287,10 @@ void swap(System *sys) {
     // Shorthand
     Process *p = &sys->table.p[sys->table.context];
 
-    int candidate, target = (p->mem / sys->page_size) - p->n_pages;
+    int candidate, target = p->mem / sys->page_size;
 
     p->time.load = 0;
-    p->status = LOADING;
+    sys->table.states[sys->table.context] = LOADING;
 
     while (p->n_pages < target) {
 
@@ -193,9 +299,102 @@ void swap(System *sys) {
         if (p->n_pages < target) {
             
             candidate = oldest(*sys);
-            evict_process(sys, sys->table.p[candidate].id, sys->table.p[candidate].n_pages);
+            evict_process(sys, candidate, sys->table.p[candidate].n_pages);
+        }
+    }
+}
+
+// Comparison used by compare_ref() while sorting
+static _Thread_local int (*compare_by)(const void *, const void *) = NULL;
+
+/*
+ * Comparison function for qsort that compares the processes
+ * pointed to by an array of pointers.
+ */
+static int compare_ref(const void *a, const void *b) {
+
+    return compare_by(*(Process* const*)a, *(Process* const*)b);
+}
+
+/*
+ * Sorts an array of pointers to processes by a comparison of the
+ * processes they point to.
+ * 
+ * Process **refs: Array of pointers to processes.
+ * int n:          Number of pointers.
+ * int (*compare): qsort style comparison function for two processes.
+ */
+void sort_processes(Process **refs, int n, int (*compare)(const void *, const void *)) {
+
+    compare_by = compare;
+    qsort(refs, n, sizeof(Process*), compare_ref);
+}
+
+/*
+ * Lists the processes with pages in memory, ordered by a comparison
+ * of processes. Only pointers are sorted, not the processes.
+ * 
+ * System *sys:    Pointer to an OS struct.
+ * int (*compare): qsort style comparison function for two processes.
+ * int *n:         Set to the number of processes listed.
+ * 
+ * Returns Process**: malloc'd array of pointers into the process table.
+ */
+Process **resident(System *sys, int (*compare)(const void *, const void *), int *n) {
+
+    int n_listed = 0, k = 0;
+    Process **listed = (Process**)malloc(max(sys->n_used, 1) * sizeof(Process*));
+
+    for (int i = frames_next_used(sys->frames, 0); i != UNDEF; i = frames_next_used(sys->frames, i + 1)) {
+        listed[n_listed++] = &sys->table.p[sys->frames->owner[i]];
+    }
+
+    sort_processes(listed, n_listed, compare);
+
+    // The order is total so each process' pages end up together
+    for (int i = 0; i < n_listed; i++) {
+        if (!k || listed[i] != listed[k - 1]) listed[k++] = listed[i];
+    }
+
+    *n = k;
+    return listed;
+}
+
+/*
+ * Finds pages to evict from processes other than the one in the
+ * current context, taking every page of each process in turn.
+ * 
+ * System *sys:      Pointer to an OS struct.
+ * Process **order:  Processes to take pages from, in order.
+ * int n_order:      Number of processes in the order.
+ * int *candidates:  Array of memory addresses found.
+ * int n_candidates: Number of memory addresses already found.
+ * int wanted:       Number of memory addresses wanted.
+ * 
+ * Returns int: Number of memory addresses found.
+ */
+int find_victims(System *sys, Process **order, int n_order, int *candidates, int n_candidates,
+                 int wanted) {
+
+    int pix, addr, next;
+
+    for (int i = 0; i < n_order && n_candidates < wanted; i++) {
+
+        pix = order[i] - sys->table.p;
+
+        if (pix == sys->table.context || pinned(sys, pix)) continue;
+
+        for (addr = 0; n_candidates < wanted &&
+             (next = frames_next_owned(sys->frames, pix, addr)) != UNDEF; addr = next + 1) {
+
+            PROFILE_COUNT(sys, SCANNED, next - addr + 1);
+
+            candidates[n_candidates] = next;
+            n_candidates++;
         }
     }
+
+    return n_candidates;
 }
 
 /*
@@ -208,15 +407,13 @@ void swap(System *sys) {
  */
 void virtual(System *sys) {
 
-    int *candidates = NULL, n_candidates = 0, target;
+    int *candidates = NULL, n_candidates = 0, target, n_sorted;
 
     // Shorthand
     Process *p = &sys->table.p[sys->table.context];
 
-    // Copy of processes sorted by time last allocated
-    Process *sorted = (Process*)malloc(sys->table.n * sizeof(Process));
-    memmove(sorted, sys->table.p, sys->table.n * sizeof(Process));
-    qsort(sorted, sys->table.n, sizeof(Process), compare_last);
+    // Processes with pages in memory sorted by time last allocated
+    Process **sorted = resident(sys, compare_last, &n_sorted);
 
     p->time.load = 0;
 
@@ -232,14 +429,8 @@ void virtual(System *sys) {
         if (p->n_pages < target) {
             
             // Find evictable pages in sorted array
-            for (int i = 0; i < sys->table.n; i++) {
-                for (int j = 0; j < sys->n_pages && n_candidates < (target - p->n_pages); j++) {
-                    if (sys->pages[j].pid == sorted[i].id && sys->pages[j].pid != p->id) {
-                        candidates[n_candidates] = j;
-                        n_candidates++;
-                    }
-                }
-            }
+            n_candidates = find_victims(sys, sorted, n_sorted, candidates, n_candidates,
+                                        target - p->n_pages);
 
             // Sort in increasing order of memory address
             qsort(candidates, n_candidates, sizeof(int), compare_int);
@@ -248,9 +439,28 @@ void virtual(System *sys) {
         }
     }
 
-    // Increase remaining time for page fault
-    p->time.remaining += (p->mem / sys->page_size) - p->n_pages;
-
     free(candidates);
     free(sorted);
 }
+
+/*
+ * Finds the page fault time added to the remaining time of the
+ * current context as it is dispatched, for the allocators that
+ * charge page faults that way.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * 
+ * Returns Time: Number of its pages left out of memory, or 0.
+ */
+Time fault_penalty(System *sys) {
+
+    // Shorthand
+    Process *p = &sys->table.p[sys->table.context];
+
+    switch (sys->allocator) {
+
+        case V: return (p->mem / sys->page_size) - p->n_pages;
+        case CM: return (p->mem / PAGE_SIZE) - p->n_pages;
+        default: return 0;
+    }
+}
@@ -0,0 +1,175 @@
+/*
+ * mlfq.c
+ * 
+ * A Multi-Level Feedback Queue process scheduling algorithm
+ * to run for a process scheduling simulator. Written for
+ * project 2 of COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+
+#include "mlfq.h"
+
+/*
+ * Allocates a queue for each priority level.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void mlfq_init(System *sys) {
+
+    sys->queues = (Queue**)calloc(1, sys->levels * sizeof(Queue*));
+
+    for (int i = 0; i < sys->levels; i++) {
+        sys->queues[i] = create_queue(sys->table.n);
+    }
+
+    sys->boosted = sys->time;
+}
+
+/*
+ * Frees the priority level queues.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void mlfq_free(System *sys) {
+
+    if (sys->queues == NULL) return;
+
+    for (int i = 0; i < sys->levels; i++) free_queue(sys->queues[i]);
+
+    free(sys->queues);
+    sys->queues = NULL;
+}
+
+/*
+ * Receives a newly arrived process into the highest priority level.
+ * 
+ * System *sys: Pointer to the OS.
+ * int i:       Index in the process table of the new process.
+ */
+void mlfq_admit(System *sys, int i) {
+
+    sys->table.p[i].level = 0;
+    enqueue(sys->queues[0], i);
+}
+
+/*
+ * Moves every waiting process back to the highest priority level
+ * once per boost period so that demoted processes cannot starve.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void mlfq_boost(System *sys) {
+
+    if (sys->time - sys->boosted < sys->boost) return;
+
+    for (int i = 1; i < sys->levels; i++) {
+        while (sys->queues[i]->n) {
+
+            int j = dequeue(sys->queues[i]);
+
+            sys->table.p[j].level = 0;
+            enqueue(sys->queues[0], j);
+        }
+    }
+
+    sys->boosted = sys->time;
+}
+
+/*
+ * Updates the current context to be the front of the
+ * highest priority non-empty level.
+ * 
+ * System *sys: Pointer to an OS.
+ * 
+ * returns Status: Enumerated status flag.
+ */
+Status mlfq_context(System *sys) {
+
+    for (int i = 0; i < sys->levels; i++) {
+        if (sys->queues[i]->n) {
+            sys->table.context = dequeue(sys->queues[i]);
+            return READY;
+        }
+    }
+
+    // No valid process found
+    return TERMINATED;
+}
+
+/*
+ * Handles a clock cycle for the OS according to
+ * Multi-Level Feedback Queue scheduling.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void mlfq_step(System *sys) {
+
+    Time runtime;
+    Process *p = NULL;
+    Status dispatched;
+
+    switch (sys->status) {
+
+        // New process
+        case READY:
+
+            mlfq_boost(sys);
+
+            // Update current context, or stop running if no processes available
+            if (profile_context(sys, mlfq_context) == TERMINATED) {
+                sys->status = TERMINATED;
+                break;
+            }
+
+            if (sys->table.states[sys->table.context] == START) {
+                dispatched = process_start(sys);
+            } else {
+                dispatched = process_resume(sys);
+            }
+
+            // Dispatch another process while its pages load
+            if (dispatched == LOADING) break;
+
+            sys->status = RUNNING;
+
+            break;
+
+        case RUNNING:
+
+            // Shorthand
+            p = &sys->table.p[sys->table.context];
+
+            // Quantum doubles with each level the process has been demoted,
+            // shifted as a Time and capped so deep levels can't overflow
+            runtime = (Time)sys->quantum << min(p->level, MLFQ_MAX_SHIFT);
+            runtime = min(runtime, p->time.remaining);
+            runtime = burst_limit(sys, runtime);
+
+            process_run(sys, runtime);
+
+            // Check if process has finished
+            if ((p->time.remaining - runtime)) {
+
+                // Newly arrived processes are queued ahead of the paused one, and
+                // one blocking for I/O keeps its level until it is queued again
+                if (process_pause(sys) == READY) {
+
+                    // Used its whole quantum so demote it
+                    p->level = min(p->level + 1, sys->levels - 1);
+                    enqueue(sys->queues[p->level], sys->table.context);
+                }
+            } else {
+                process_finish(sys);
+            }
+
+            sys->status = READY;
+
+            break;
+
+        default: break;
+    }
+}
@@ -0,0 +1,232 @@
+/*
+ * online.c
+ *
+ * Online running of an OS, reading processes from stdin or a Unix
+ * domain socket as they arrive rather than from a whole file. The
+ * clock is driven by the input, so the OS only runs up to the latest
+ * time every arrival is known for, and events are printed as they
+ * happen with the time taken to decide each recorded. Written for
+ * project 2 of COMP30023 Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "online.h"
+
+/*
+ * Waits for a connection on a Unix domain socket.
+ */
+static int accept_socket(char *path) {
+
+    struct sockaddr_un addr;
+    int fd, client;
+
+    // Longer paths would be cut short and bind somewhere else
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path %s is too long\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path, strlen(path) + 1);
+
+    // A socket left by an earlier run would stop this one binding
+    unlink(path);
+
+    if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) exit(EXIT_FAILURE);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) || listen(fd, 1)) exit(EXIT_FAILURE);
+    if ((client = accept(fd, NULL, NULL)) < 0) exit(EXIT_FAILURE);
+
+    close(fd);
+    unlink(path);
+
+    return client;
+}
+
+/*
+ * Starts reading processes for an OS with an empty process table,
+ * from stdin or by waiting for a connection on a Unix domain socket,
+ * to which events are then also printed.
+ *
+ * System *sys:  Pointer to an OS struct that has not been run.
+ * char *source: ONLINE_STDIN, or the path of the socket to listen on.
+ */
+void online_init(System *sys, char *source) {
+
+    Online *o = (Online*)calloc(1, sizeof(Online));
+    int fd;
+
+    // Only algorithms whose decisions never look ahead to arrivals not yet read
+    if ((sys->scheduler != FF && sys->scheduler != RR && sys->scheduler != CS) ||
+        sys->allocator == D || sys->bandwidth > 0 || sys->fragmentation || sys->compaction != UNDEF) {
+        fprintf(stderr, "Online mode supports ff, rr and cs with u, p, v and cm\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!strcmp(source, ONLINE_STDIN)) {
+        o->in = stdin;
+    } else {
+        fd = accept_socket(source);
+        o->in = fdopen(fd, "r");
+        sys->out = fdopen(dup(fd), "w");
+        o->socket = 1;
+    }
+
+    // Nothing is known until the first line, even at time 0
+    o->horizon = -1;
+    o->latency = (Sketch*)calloc(1, sizeof(Sketch));
+    clock_gettime(CLOCK_MONOTONIC, &o->read);
+
+    sys->online = o;
+}
+
+/*
+ * Stops reading processes for an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void online_free(System *sys) {
+
+    // Shorthand
+    Online *o = sys->online;
+
+    if (o == NULL) return;
+
+    if (o->socket) {
+        fclose(o->in);
+        fclose(sys->out);
+        sys->out = NULL;
+    }
+
+    free(o->latency);
+    free(o);
+
+    sys->online = NULL;
+}
+
+/*
+ * Reads a line of input, which is either a process or a time that
+ * every arrival up to has been sent.
+ *
+ * Returns int: 0 if the input has ended, 1 otherwise.
+ */
+static int read_line(System *sys) {
+
+    char *line = NULL;
+    size_t len = 0;
+    Time tick;
+    Process swap;
+
+    // Shorthand
+    Online *o = sys->online;
+    PTable *t = &sys->table;
+
+    if (o->eof) return 0;
+
+    if (getline(&line, &len, o->in) == -1) {
+        o->eof = 1;
+        free(line);
+        clock_gettime(CLOCK_MONOTONIC, &o->read);
+        return 0;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &o->read);
+
+    // Grow the table by doubling so each process is only copied a few times
+    if (t->n == o->size) {
+        o->size = max(2 * o->size, 1);
+        t->p = (Process*)realloc(t->p, o->size * sizeof(Process));
+        t->states = (Status*)realloc(t->states, o->size * sizeof(Status));
+    }
+
+    if (read_process(line, &t->p[t->n])) {
+
+        // Shorthand
+        Process *p = &t->p[t->n];
+
+        // Arrivals are read in order, so a late one arrives as soon as it still can
+        if (p->time.arrived <= o->horizon) {
+            fprintf(stderr, "Process %d arrived late at %lld, moved to %lld\n",
+                    p->id, p->time.arrived, o->horizon + 1);
+            p->time.arrived = o->horizon + 1;
+        }
+
+        // More processes may still arrive at the same time
+        o->horizon = p->time.arrived - 1;
+        t->states[t->n] = INIT;
+
+        // Processes arriving together are in order of ID, as when read from a file
+        for (int i = t->n++; i > t->next && compare(&t->p[i - 1], &t->p[i]) > 0; i--) {
+            swap = t->p[i];
+            t->p[i] = t->p[i - 1];
+            t->p[i - 1] = swap;
+        }
+
+    } else if (sscanf(line, "%lld", &tick) == 1) {
+        o->horizon = max(o->horizon, tick);
+    }
+
+    free(line);
+
+    return 1;
+}
+
+/*
+ * Reads processes until every arrival up to a time is known, or the
+ * input ends. Does nothing if the OS is not online.
+ *
+ * System *sys: Pointer to an OS struct.
+ * Time until:  Time arrivals must be known up to.
+ */
+void online_until(System *sys, Time until) {
+
+    if (sys->online == NULL) return;
+
+    while (sys->online->horizon < until && read_line(sys));
+}
+
+/*
+ * Reads processes until one more is in the process table, or the
+ * input ends. Does nothing if the OS is not online.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void online_next(System *sys) {
+
+    int n = sys->table.n;
+
+    if (sys->online == NULL) return;
+
+    while (sys->table.n == n && read_line(sys));
+}
+
+/*
+ * Records the time taken to decide an event that has been printed,
+ * and sends it on.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void online_decided(System *sys) {
+
+    struct timespec now;
+    long long ns;
+
+    // Shorthand
+    Online *o = sys->online;
+
+    fflush(sys->out);
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    ns = (now.tv_sec - o->read.tv_sec) * 1000000000LL + now.tv_nsec - o->read.tv_nsec;
+
+    sketch_add(o->latency, ns);
+    o->latency_max = max(ns, o->latency_max);
+}
@@ -0,0 +1,135 @@
+/*
+ * pheap.c
+ * 
+ * A pairing heap of process table indices, ordered by a qsort
+ * style comparison of the processes, for use by the scheduling
+ * algorithms. Written for project 2 of COMP30023 Computer
+ * Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+
+#include "pheap.h"
+
+/*
+ * Joins two subtrees, making the larger root the leftmost
+ * child of the smaller.
+ * 
+ * Returns int: Root of the joined subtree.
+ */
+static int meld(PHeap *h, int a, int b) {
+
+    char *base = *h->base;
+
+    if (a < 0) return b;
+    if (b < 0) return a;
+
+    if (h->compare(base + b * h->width, base + a * h->width) < 0) {
+        int tmp = a;
+        a = b;
+        b = tmp;
+    }
+
+    h->next[b] = h->child[a];
+    h->child[a] = b;
+    h->next[a] = -1;
+
+    return a;
+}
+
+/*
+ * Allocates memory for a new, empty pairing heap.
+ * 
+ * void **base:    Pointer to the array of records that will be indexed.
+ * int size:       Number of records in the array.
+ * size_t width:   Size in bytes of each record.
+ * int (*compare): qsort style comparison function for two records.
+ * 
+ * Returns PHeap*: Pointer to the new PHeap struct.
+ */
+PHeap *create_pheap(void **base, int size, size_t width,
+                    int (*compare)(const void *, const void *)) {
+
+    PHeap *h = (PHeap*)calloc(1, sizeof(PHeap));
+
+    h->size = size > 0 ? size : 1;
+    h->child = (int*)malloc(h->size * sizeof(int));
+    h->next = (int*)malloc(h->size * sizeof(int));
+    h->pairs = (int*)malloc(h->size * sizeof(int));
+    h->root = -1;
+    h->n = 0;
+    h->base = base;
+    h->width = width;
+    h->compare = compare;
+
+    return h;
+}
+
+/*
+ * Frees a pairing heap and its arrays.
+ * 
+ * PHeap *h: Pointer to a pairing heap.
+ */
+void free_pheap(PHeap *h) {
+
+    if (h == NULL) return;
+
+    free(h->child);
+    free(h->next);
+    free(h->pairs);
+    free(h);
+}
+
+/*
+ * Adds a record index to a pairing heap in O(1).
+ * 
+ * PHeap *h: Pointer to a pairing heap.
+ * int i:    Index of the record to add.
+ */
+void pheap_push(PHeap *h, int i) {
+
+    h->child[i] = h->next[i] = -1;
+    h->root = meld(h, h->root, i);
+    h->n++;
+}
+
+/*
+ * Removes the index of the smallest record from a pairing heap
+ * in amortised O(log n).
+ * 
+ * PHeap *h: Pointer to a non-empty pairing heap.
+ * 
+ * Returns int: Index of the smallest record.
+ */
+int pheap_pop(PHeap *h) {
+
+    int i = h->root, n_pairs = 0, sibling, root = -1;
+
+    // First pass joins the children of the old root in pairs from the left
+    for (int c = h->child[i]; c >= 0; c = sibling) {
+
+        sibling = h->next[c];
+        h->next[c] = -1;
+
+        if (sibling >= 0) {
+            int after = h->next[sibling];
+            h->next[sibling] = -1;
+            c = meld(h, c, sibling);
+            sibling = after;
+        }
+
+        h->pairs[n_pairs++] = c;
+    }
+
+    // Second pass joins the pairs from the right
+    while (n_pairs) root = meld(h, root, h->pairs[--n_pairs]);
+
+    h->root = root;
+    h->n--;
+    h->child[i] = h->next[i] = -1;
+
+    return i;
+}
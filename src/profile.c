@@ -0,0 +1,61 @@
+/*
+ * profile.c
+ *
+ * Counters of the time spent in and the work done by each phase
+ * of the OS, compiled in only when built with PROFILE defined.
+ * Written for project 2 of COMP30023 Computer Systems, semester 1
+ * 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "profile.h"
+
+/*
+ * Starts counting for an OS, if counters are compiled in.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void profile_init(System *sys) {
+
+#ifdef PROFILE
+    sys->profile = (Profile*)calloc(1, sizeof(Profile));
+#else
+    (void)sys;
+    fprintf(stderr, "Counters are not compiled in, build with make PROFILE=1\n");
+#endif
+}
+
+/*
+ * Prints the counters of an OS to stderr and frees them.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void profile_free(System *sys) {
+
+    // Shorthand
+    Profile *p = sys->profile;
+
+    char *names[N_PHASES] = { "Admission", "Context", "Allocation", "Eviction", "Output" };
+
+    if (p == NULL) return;
+
+    fprintf(stderr, "%-12s %12s %16s %12s\n", "Phase", "Calls", "Cycles", "Cycles/call");
+
+    for (int i = 0; i < N_PHASES; i++) {
+        fprintf(stderr, "%-12s %12llu %16llu %12llu\n", names[i],
+                (unsigned long long)p->calls[i], (unsigned long long)p->cycles[i],
+                (unsigned long long)(p->calls[i] ? p->cycles[i] / p->calls[i] : 0));
+    }
+
+    fprintf(stderr, "Frames scanned %llu\n", (unsigned long long)p->counts[SCANNED]);
+    fprintf(stderr, "Pages allocated %llu\n", (unsigned long long)p->counts[ALLOCATED]);
+    fprintf(stderr, "Pages evicted %llu\n", (unsigned long long)p->counts[EVICTED]);
+
+    free(p);
+    sys->profile = NULL;
+}
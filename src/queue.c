@@ -0,0 +1,83 @@
+/*
+ * queue.c
+ * 
+ * A growable First-In-First-Out queue of process table indices
+ * for use by the scheduling algorithms. Written for project 2
+ * of COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "queue.h"
+
+/*
+ * Allocates memory for a new, empty queue.
+ * 
+ * int size: Initial capacity of the queue.
+ * 
+ * Returns Queue*: Pointer to the new Queue struct.
+ */
+Queue *create_queue(int size) {
+
+    Queue *q = (Queue*)calloc(1, sizeof(Queue));
+
+    q->size = size > 0 ? size : 1;
+    q->items = (int*)malloc(q->size * sizeof(int));
+    q->head = q->n = 0;
+
+    return q;
+}
+
+/*
+ * Frees a queue and its buffer.
+ * 
+ * Queue *q: Pointer to a queue.
+ */
+void free_queue(Queue *q) {
+
+    if (q == NULL) return;
+
+    free(q->items);
+    free(q);
+}
+
+/*
+ * Adds a value to the back of a queue, growing it if full.
+ * 
+ * Queue *q: Pointer to a queue.
+ * int v:    Value to add.
+ */
+void enqueue(Queue *q, int v) {
+
+    if (q->n == q->size) {
+
+        // Double the buffer and unwrap the items that had wrapped around
+        q->items = (int*)realloc(q->items, 2 * q->size * sizeof(int));
+        memmove(q->items + q->size, q->items, q->head * sizeof(int));
+        q->size *= 2;
+    }
+
+    q->items[(q->head + q->n) % q->size] = v;
+    q->n++;
+}
+
+/*
+ * Removes the value at the front of a queue.
+ * 
+ * Queue *q: Pointer to a non-empty queue.
+ * 
+ * Returns int: The removed value.
+ */
+int dequeue(Queue *q) {
+
+    int v = q->items[q->head];
+
+    q->head = (q->head + 1) % q->size;
+    q->n--;
+
+    return v;
+}
@@ -0,0 +1,392 @@
+/*
+ * replace.c
+ * 
+ * Page replacement policies for demand paging, choosing which
+ * page in memory to replace when a page fault occurs and memory
+ * is full. Written for project 2 of COMP30023 Computer Systems,
+ * semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+
+#include "replace.h"
+
+// Lists of nodes. LRU and second-chance only use the first.
+enum { T1, T2, B1, B2 };
+
+/*
+ * qsort comparison function for the K-th most recent reference
+ * to a page, then the most recent. Pages referenced fewer than K
+ * times come first.
+ */
+int compare_kth(const void *a, const void *b) {
+
+    const Frame *f1 = a, *f2 = b;
+
+    if (f1->hist[LRUK_K - 1] < f2->hist[LRUK_K - 1]) return -1;
+    if (f1->hist[LRUK_K - 1] == f2->hist[LRUK_K - 1]) {
+        if (f1->hist[0] < f2->hist[0]) return -1;
+        if (f1->hist[0] == f2->hist[0]) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Adds a node to the back (most recent end) of a list.
+ */
+static void push_back(Replacer *r, int l, int x) {
+
+    Frame *f = r->frames;
+
+    f[x].list = l;
+    f[x].next = UNDEF;
+    f[x].prev = r->tail[l];
+
+    if (r->tail[l] != UNDEF) {
+        f[r->tail[l]].next = x;
+    } else {
+        r->head[l] = x;
+    }
+
+    r->tail[l] = x;
+    r->size[l]++;
+}
+
+/*
+ * Removes a node from whichever list holds it.
+ */
+static void detach(Replacer *r, int x) {
+
+    Frame *f = r->frames;
+    int l = f[x].list;
+
+    if (l == UNDEF) return;
+
+    if (f[x].prev != UNDEF) {
+        f[f[x].prev].next = f[x].next;
+    } else {
+        r->head[l] = f[x].next;
+    }
+
+    if (f[x].next != UNDEF) {
+        f[f[x].next].prev = f[x].prev;
+    } else {
+        r->tail[l] = f[x].prev;
+    }
+
+    f[x].list = UNDEF;
+    r->size[l]--;
+}
+
+/*
+ * Forgets a ghost, returning its node to the unused stack.
+ */
+static void ghost_drop(System *sys, int g) {
+
+    Replacer *r = sys->replacer;
+
+    sys->table.p[r->frames[g].pix].ghost[r->frames[g].vpn] = UNDEF;
+
+    detach(r, g);
+    r->spare[r->n_spare++] = g;
+}
+
+/*
+ * Remembers a replaced page as a ghost at the back of a list.
+ */
+static void ghost_add(System *sys, int l, int pix, int vpn) {
+
+    Replacer *r = sys->replacer;
+    Process *p = &sys->table.p[pix];
+    int g, n = max(p->mem / PAGE_SIZE, 1);
+
+    // Reclaim the oldest ghost if every node is in use
+    if (!r->n_spare) ghost_drop(sys, r->head[r->size[B2] ? B2 : B1]);
+
+    // Lookup from the process' pages to their ghosts is made on first use
+    if (p->ghost == NULL) {
+        p->ghost = (int*)malloc(n * sizeof(int));
+        for (int i = 0; i < n; i++) p->ghost[i] = UNDEF;
+    }
+
+    g = r->spare[--r->n_spare];
+    r->frames[g].pix = pix;
+    r->frames[g].vpn = vpn;
+    p->ghost[vpn] = g;
+
+    push_back(r, l, g);
+}
+
+/*
+ * Adaptive Replacement Cache. Pages referenced once are kept in T1
+ * and pages referenced again in T2, with ghosts of pages replaced
+ * from each kept in B1 and B2. A miss on a ghost shifts the target
+ * size of T1 towards the list it was replaced from.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int vpn:     Missing page of the process in the current context.
+ * int addr:    Memory address of a free page, or UNDEF if full.
+ * 
+ * Returns int: Memory address to load the page into.
+ */
+static int arc_miss(System *sys, int vpn, int addr) {
+
+    Replacer *r = sys->replacer;
+    Process *p = &sys->table.p[sys->table.context];
+    int c = r->n, g = p->ghost == NULL ? UNDEF : p->ghost[vpn], in_b2 = 0, l, victim;
+    int *size = r->size;
+
+    r->promote = g != UNDEF;
+
+    if (g != UNDEF) {
+
+        // Adapt towards recency after a B1 hit, or frequency after a B2 hit
+        if (r->frames[g].list == B1) {
+            r->target = min(c, r->target + max(size[B2] / size[B1], 1));
+        } else {
+            in_b2 = 1;
+            r->target = max(0, r->target - max(size[B1] / size[B2], 1));
+        }
+
+        ghost_drop(sys, g);
+
+    } else if (size[T1] + size[B1] >= c) {
+        if (size[B1]) ghost_drop(sys, r->head[B1]);
+    } else if (size[T1] + size[T2] + size[B1] + size[B2] >= 2 * c) {
+        if (size[B2]) ghost_drop(sys, r->head[B2]);
+    }
+
+    if (addr != UNDEF) return addr;
+
+    // Replace from T1 if it is above its target size, otherwise from T2
+    if (size[T1] && ((in_b2 && size[T1] == r->target) || size[T1] > r->target)) {
+        victim = r->head[T1];
+        l = B1;
+    } else if (size[T2]) {
+        victim = r->head[T2];
+        l = B2;
+    } else {
+        victim = r->head[T1];
+        l = B1;
+    }
+
+    detach(r, victim);
+    ghost_add(sys, l, sys->pages[victim].pix, sys->pages[victim].vpn);
+
+    return victim;
+}
+
+/*
+ * Allocates the replacement state for the memory of an OS.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void replace_init(System *sys) {
+
+    Replacer *r = (Replacer*)calloc(1, sizeof(Replacer));
+
+    r->policy = sys->policy;
+    r->n = sys->n_pages;
+
+    // Memory pages followed by up to two ghosts for each
+    r->frames = (Frame*)malloc(3 * max(r->n, 1) * sizeof(Frame));
+    r->spare = (int*)malloc(2 * max(r->n, 1) * sizeof(int));
+
+    for (int i = 0; i < 3 * r->n; i++) {
+        r->frames[i].prev = r->frames[i].next = r->frames[i].list = UNDEF;
+        r->frames[i].ref = 0;
+        for (int k = 0; k < LRUK_K; k++) r->frames[i].hist[k] = UNDEF;
+    }
+
+    // Ghost nodes are handed out from the bottom of the stack first
+    for (int i = 3 * r->n - 1; i >= r->n; i--) r->spare[r->n_spare++] = i;
+
+    for (int l = T1; l <= B2; l++) {
+        r->head[l] = r->tail[l] = UNDEF;
+        r->size[l] = 0;
+    }
+
+    if (r->policy == LRUK) {
+        r->heap = create_heap((void**)&r->frames, r->n, sizeof(Frame), compare_kth);
+    }
+
+    sys->replacer = r;
+}
+
+/*
+ * Frees the replacement state of an OS.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void replace_free(System *sys) {
+
+    Replacer *r = sys->replacer;
+
+    if (r == NULL) return;
+
+    for (int i = 0; i < sys->table.n; i++) {
+        free(sys->table.p[i].ghost);
+        sys->table.p[i].ghost = NULL;
+    }
+
+    free_heap(r->heap);
+    free(r->frames);
+    free(r->spare);
+    free(r);
+
+    sys->replacer = NULL;
+}
+
+/*
+ * Chooses the memory page to load a missing page into, updating
+ * the policy's history. If a free page is given it is used,
+ * otherwise another page is chosen to be replaced and is removed
+ * from the policy but left for the caller to evict.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int vpn:     Missing page of the process in the current context.
+ * int addr:    Memory address of a free page, or UNDEF if full.
+ * 
+ * Returns int: Memory address to load the page into.
+ */
+int replace_miss(System *sys, int vpn, int addr) {
+
+    Replacer *r = sys->replacer;
+    Frame *f = r->frames;
+    int victim = addr;
+
+    if (r->policy == ARC) return arc_miss(sys, vpn, addr);
+
+    if (addr != UNDEF) return addr;
+
+    switch (r->policy) {
+
+        // Least recently referenced is at the front of the list
+        case LRU: victim = r->head[T1]; break;
+
+        // Oldest page, moving referenced pages to the back once
+        case SC:
+            while (f[r->head[T1]].ref) {
+                victim = r->head[T1];
+                f[victim].ref = 0;
+                detach(r, victim);
+                push_back(r, T1, victim);
+            }
+            victim = r->head[T1];
+            break;
+
+        // Next page around memory that has not been referenced since last passed
+        case CLOCK:
+            while (f[r->hand].ref) {
+                f[r->hand].ref = 0;
+                r->hand = (r->hand + 1) % r->n;
+            }
+            victim = r->hand;
+            r->hand = (r->hand + 1) % r->n;
+            break;
+
+        // Furthest K-th most recent reference
+        case LRUK: victim = r->heap->items[0]; break;
+
+        default: break;
+    }
+
+    replace_remove(sys, victim);
+
+    return victim;
+}
+
+/*
+ * Adds a newly loaded page to the policy. Counts as the first
+ * reference to the page.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ */
+void replace_insert(System *sys, int addr) {
+
+    Replacer *r = sys->replacer;
+    Frame *f = &r->frames[addr];
+
+    switch (r->policy) {
+
+        case LRU:
+        case SC:
+            f->ref = 0;
+            push_back(r, T1, addr);
+            break;
+
+        case CLOCK: f->ref = 1; break;
+
+        case LRUK:
+            for (int k = 0; k < LRUK_K; k++) f->hist[k] = UNDEF;
+            f->hist[0] = sys->time;
+            heap_push(r->heap, addr);
+            break;
+
+        // Pages that were ghosts have been referenced before
+        case ARC:
+            push_back(r, r->promote ? T2 : T1, addr);
+            r->promote = 0;
+            break;
+
+        default: break;
+    }
+}
+
+/*
+ * Records a reference to a page in memory.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ */
+void replace_touch(System *sys, int addr) {
+
+    Replacer *r = sys->replacer;
+    Frame *f = &r->frames[addr];
+
+    switch (r->policy) {
+
+        case LRU:
+            detach(r, addr);
+            push_back(r, T1, addr);
+            break;
+
+        case SC:
+        case CLOCK: f->ref = 1; break;
+
+        case LRUK:
+            for (int k = LRUK_K - 1; k > 0; k--) f->hist[k] = f->hist[k - 1];
+            f->hist[0] = sys->time;
+            heap_update(r->heap, addr);
+            break;
+
+        // Pages referenced again move to the frequency list
+        case ARC:
+            detach(r, addr);
+            push_back(r, T2, addr);
+            break;
+
+        default: break;
+    }
+}
+
+/*
+ * Removes a page from the policy when it is freed. Does nothing
+ * if the page is not held by the policy.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int addr:    Memory address of the page.
+ */
+void replace_remove(System *sys, int addr) {
+
+    Replacer *r = sys->replacer;
+
+    detach(r, addr);
+    r->frames[addr].ref = 0;
+
+    if (r->heap != NULL) heap_remove(r->heap, addr);
+}
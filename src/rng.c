@@ -0,0 +1,60 @@
+/*
+ * rng.c
+ * 
+ * A small, seedable pseudo-random number generator giving
+ * independent streams for each process so that simulations are
+ * reproducible. Written for project 2 of COMP30023 Computer
+ * Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include "rng.h"
+
+/*
+ * Derives the starting state of an independent stream.
+ * 
+ * uint64_t seed:   Seed shared by every stream in a simulation.
+ * uint64_t stream: Identifier of the stream, e.g. a process ID.
+ * 
+ * Returns uint64_t: Starting state of the stream.
+ */
+uint64_t rng_seed(uint64_t seed, uint64_t stream) {
+
+    uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+
+    // Scramble so that neighbouring streams are unrelated
+    rng_next(&state);
+
+    return state;
+}
+
+/*
+ * Advances a stream and returns its next value (SplitMix64).
+ * 
+ * uint64_t *state: Pointer to the state of a stream.
+ * 
+ * Returns uint64_t: Uniformly distributed 64 bit value.
+ */
+uint64_t rng_next(uint64_t *state) {
+
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+/*
+ * Advances a stream and returns its next value as a fraction.
+ * 
+ * uint64_t *state: Pointer to the state of a stream.
+ * 
+ * Returns double: Uniformly distributed value in [0, 1).
+ */
+double rng_uniform(uint64_t *state) {
+
+    return (rng_next(state) >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -11,6 +11,15 @@
 
 #include "rr.h"
 
+/*
+ * Checks if a process can't be run yet, as it hasn't been received
+ * or is blocked for I/O.
+ */
+static int held(System *sys, int i) {
+
+    return sys->table.states[i] == INIT || sys->table.states[i] == BLOCKED;
+}
+
 /*
  * Updates the current context in the process table.
  * 
@@ -24,17 +33,28 @@ Status rr_context(System *sys) {
     
     // Shorthand
     Process *p = sys->table.p;
+    Status *s = sys->table.states;
 
     // Initialise to a value to compare with
-    if (sys->table.context == UNDEF) {
-        sys->table.context = 0;
-        flag = READY;
+    if (sys->table.context == UNDEF) sys->table.context = 0;
+
+    // Ensure we're not including terminated or waiting processes
+    if (s[sys->table.context] == TERMINATED || held(sys, sys->table.context)) {
+        for (int i = 0; i < sys->table.n; i++) {
+            if (s[i] != TERMINATED && !held(sys, i)) {
+                sys->table.context = i;
+                break;
+            }
+        }
+
+        // Nothing else can run
+        if (held(sys, sys->table.context)) flag = TERMINATED;
     }
 
-    // Ensure we're not including terminated processes
-    if (p[sys->table.context].status == TERMINATED) {
+    // Processes waiting for their pages can't run until they load
+    if (s[sys->table.context] == LOADING) {
         for (int i = 0; i < sys->table.n; i++) {
-            if (p[i].status != TERMINATED) {
+            if (s[i] == START || s[i] == READY) {
                 sys->table.context = i;
                 break;
             }
@@ -43,9 +63,9 @@ Status rr_context(System *sys) {
 
     // Set context to be the least recently executed or received process
     for (int i = 0; i < sys->table.n; i++) {
-        if (p[i].status == START || p[i].status == READY) {
+        if (s[i] == START || s[i] == READY) {
             
-            if (p[i].time.last < p[sys->table.context].time.last && p[sys->table.context].status != TERMINATED) {
+            if (p[i].time.last < p[sys->table.context].time.last && s[sys->table.context] != TERMINATED) {
                 sys->table.context = i;
             } else if (p[i].time.last == p[sys->table.context].time.last) {
                 if (p[i].time.arrived > p[sys->table.context].time.arrived) sys->table.context = i;
@@ -59,6 +79,26 @@ Status rr_context(System *sys) {
     return flag;
 }
 
+/*
+ * Updates the current context to be the front of the ready
+ * queue kept when batching. Processes are queued in the order
+ * of time last executed or received, so this is the same choice
+ * as rr_context() without scanning the process table.
+ * 
+ * System *sys: Pointer to an OS.
+ * 
+ * returns Status: Enumerated status flag.
+ */
+Status rr_batch_context(System *sys) {
+
+    // No valid process found
+    if (!sys->fifo->n) return TERMINATED;
+
+    sys->table.context = dequeue(sys->fifo);
+
+    return READY;
+}
+
 /*
  * Handles a clock cycle for the OS according to
  * Round-Robin scheduling.
@@ -67,8 +107,9 @@ Status rr_context(System *sys) {
  */
 void rr_step(System *sys) {
 
-    int runtime;
+    Time runtime;
     Process *p = NULL;
+    Status dispatched;
 
     switch (sys->status) {
 
@@ -76,17 +117,20 @@ void rr_step(System *sys) {
         case READY:
 
             // Update current context, or stop running if no processes available
-            if (rr_context(sys) == TERMINATED) {
+            if (profile_context(sys, sys->batch ? rr_batch_context : rr_context) == TERMINATED) {
                 sys->status = TERMINATED;
                 break;
             } 
 
-            if (sys->table.p[sys->table.context].status == START) {
-                process_start(sys);
+            if (sys->table.states[sys->table.context] == START) {
+                dispatched = process_start(sys);
             } else {
-                process_resume(sys);
+                dispatched = process_resume(sys);
             }
 
+            // Dispatch another process while its pages load
+            if (dispatched == LOADING) break;
+
             sys->status = RUNNING;
 
             break;
@@ -96,22 +140,28 @@ void rr_step(System *sys) {
             // Shorthand
             p = &sys->table.p[sys->table.context];
 
-            // Run only for quantum time limit or time remaining
+            // Run only for quantum time limit or time remaining, or until it blocks
             runtime = sys->quantum > p->time.remaining ?
                       p->time.remaining :
                       sys->quantum;
+            runtime = burst_limit(sys, runtime);
 
-            sys->time += runtime;
+            process_run(sys, runtime);
             
             // Check if process has finished
             if ((p->time.remaining - runtime)) {
-                process_pause(sys);
+
+                // Newly arrived processes are queued ahead of the paused one
+                if (process_pause(sys) == READY && sys->batch) enqueue(sys->fifo, sys->table.context);
             } else {
                 process_finish(sys);
             }
 
             sys->status = READY;
 
+            // Dispatch the next process in the same pass when batching
+            if (sys->batch) rr_step(sys);
+
             break;
         
         default: break;
@@ -16,71 +16,251 @@
 #include <stdarg.h>
 
 #include "scheduler.h"
+#include "ensemble.h"
+#include "sweep.h"
 
-#define OPTARGS "f:a:m:s:q:vd"
+#define OPTARGS "f:a:m:s:q:l:b:g:w:Bp:S:i:PFc:k:r:V:T:xo:t:LvE:N:j:G:W:O:R:e"
 
 /*
- * Calculates and prints statistics for processes that
- * have finished.
+ * Prints statistics for processes that have finished, gathered
+ * as they finished.
  * 
- * ProcTable *proc_table: Pointer to a process table.
+ * System *sys: Pointer to an OS struct.
  */
 void print_stats(System *sys) {
 
-    // Throughput, turnaround, makespan, and overhead
-    int tp_min = INT_MAX, tp_max = 0, tp_avg = 0, trn = 0, ms = 0;
-    float oh_max = 0.0, oh_avg = 0.0;
+    // Shorthand
+    Stats *s = sys->stats;
     Process *p = sys->table.p;
 
-    // Makespan
-    for (int i = 0; i < sys->table.n; i++) {
-        ms = p[i].time.finished > ms ? p[i].time.finished : ms;
+    // Throughput, turnaround, makespan, and overhead
+    int tp_avg;
+    Time trn, ms = s->makespan;
+    float oh_avg;
+
+    uint64_t formatting = sys->verifier != NULL ? profile_cycles() : 0;
+
+    stats_close(sys);
+
+    // Averages, rounded up without passing through float
+    tp_avg = s->epochs ? (int)ceil_div(s->tp_total, s->epochs) : 0;
+    trn = ceil_div(s->turnaround_total, sys->table.n);
+    oh_avg = s->overhead_total / sys->table.n;
+
+    fprintf(sys->out, "Throughput %d, %d, %d\n", tp_avg, s->tp_min, s->tp_max);
+    fprintf(sys->out, "Turnaround time %lld\n", trn);
+    fprintf(sys->out, "Time overhead %.2f %.2f\n", s->overhead_max, oh_avg);
+    fprintf(sys->out, "Makespan %lld\n", ms);
+
+    if (sys->percentiles) {
+        fprintf(sys->out, "Turnaround time p50 %lld, p95 %lld, p99 %lld\n",
+                sketch_quantile(&s->turnaround, 0.5), sketch_quantile(&s->turnaround, 0.95),
+                sketch_quantile(&s->turnaround, 0.99));
+        fprintf(sys->out, "Waiting time p50 %lld, p95 %lld, p99 %lld\n",
+                sketch_quantile(&s->waiting, 0.5), sketch_quantile(&s->waiting, 0.95),
+                sketch_quantile(&s->waiting, 0.99));
+        fprintf(sys->out, "Time overhead p50 %.2f, p95 %.2f, p99 %.2f\n",
+                sketch_quantile(&s->overhead, 0.5) / 100.0, sketch_quantile(&s->overhead, 0.95) / 100.0,
+                sketch_quantile(&s->overhead, 0.99) / 100.0);
+    }
+
+    // Time spent waiting to be admitted is also part of turnaround time
+    if (sys->admission > 0) {
+        fprintf(sys->out, "Queueing delay %lld, %lld\n", ceil_div(s->queueing_total, sys->table.n), s->queueing_max);
+
+        if (sys->percentiles) {
+            fprintf(sys->out, "Queueing delay p50 %lld, p95 %lld, p99 %lld\n",
+                    sketch_quantile(&s->queueing, 0.5), sketch_quantile(&s->queueing, 0.95),
+                    sketch_quantile(&s->queueing, 0.99));
+        }
     }
 
-    // Throughput intervals
-    int n_intervals = ceil((float)ms / EPOCH), interval[n_intervals];
-    memset(interval, 0, n_intervals * sizeof(int));
+    // CPU time and time blocked for I/O overlap between processes
+    if (s->blocks) {
+        fprintf(sys->out, "CPU utilisation %d%%\n", ms ? (int)ceil(((float)s->cpu_total * 100) / ms) : 0);
+        fprintf(sys->out, "I/O bursts %d, %lld\n", s->blocks, s->io_total);
+    }
 
-    for (int i = 0; i < sys->table.n; i++) {
+    if (sys->allocator == D) {
 
-        if (p[i].status == TERMINATED) {
+        int faults = 0;
+        Time fault = 0;
 
-            // Increase count of processes finished in each interval
-            interval[(int)(p[i].time.finished / (EPOCH + 0.01))]++;
-        
-            // Turnaround time
-            int _trn = p[i].time.finished - p[i].time.arrived;
-            trn += _trn;
-
-            // Overhead
-            float _oh = (float)_trn / p[i].time.job;
-            oh_max = _oh > oh_max ? _oh : oh_max;
-            oh_avg += _oh;\
+        for (int i = 0; i < sys->table.n; i++) {
+            faults += p[i].faults;
+            fault += p[i].time.fault;
         }
+
+        fprintf(sys->out, "Page faults %d, %.2f\n", faults, (float)faults / sys->table.n);
+        fprintf(sys->out, "Fault time %lld, %.2f\n", fault, (float)fault / sys->table.n);
+    }
+
+    if (sys->store != NULL) {
+
+        // Shorthand
+        Store *s = sys->store;
+
+        fprintf(sys->out, "I/O utilisation %d%%\n", ms ? (int)ceil(((float)s->busy * 100) / ms) : 0);
+        fprintf(sys->out, "I/O queue depth %.2f, %d\n",
+                s->requests ? (float)s->depth_total / s->requests : 0.0,
+                s->depth_max);
+
+        if (s->prefetch) fprintf(sys->out, "Prefetched pages %d\n", s->prefetched);
+    }
+
+    if (sys->online != NULL) {
+
+        // Shorthand
+        Online *o = sys->online;
+
+        // Middle of a bucket can be past the longest time in it
+        long long p50 = min(sketch_quantile(o->latency, 0.5), o->latency_max);
+        long long p99 = min(sketch_quantile(o->latency, 0.99), o->latency_max);
+
+        fprintf(sys->out, "Decisions %lld, latency p50 %.2fus, p99 %.2fus, max %.2fus\n", o->latency->n,
+                p50 / 1000.0, p99 / 1000.0, o->latency_max / 1000.0);
     }
 
-    // Throughput
-    for (int i = 0; i < n_intervals; i++) {
+    if (sys->frag != NULL && sys->frag->dispatches) {
 
-        tp_min = interval[i] < tp_min ? interval[i] : tp_min;
-        tp_max = interval[i] > tp_max ? interval[i] : tp_max;
-        tp_avg += interval[i];
+        // Shorthand
+        Frag *f = sys->frag;
+
+        fprintf(sys->out, "Process extents %.2f, %d\n",
+                (float)f->extents / f->dispatches, f->extents_max);
+
+        // Average number of free runs in each size bucket when dispatching
+        fprintf(sys->out, "Free extents");
+        for (int b = 0; b < FRAG_BUCKETS; b++) {
+            if (f->hist_total[b]) {
+                fprintf(sys->out, " %d:%.2f", 1 << b, (float)f->hist_total[b] / f->dispatches);
+            }
+        }
+        fprintf(sys->out, "\n");
+
+        if (f->cost != UNDEF) fprintf(sys->out, "Compaction %d, %d, %lld\n", f->passes, f->moved, f->time);
     }
 
-    // Averages
-    tp_avg = ceil((float)tp_avg / n_intervals);
-    trn = ceil((float)trn / sys->table.n);
-    oh_avg /= sys->table.n;
+    verify_output(sys, formatting);
+}
+
+
+/*
+ * Reads the name of a process scheduling algorithm.
+ * 
+ * char *name: ff, rr, cs, mlfq, srtf, cfs, ma or cp.
+ * 
+ * Returns int: Enumerated scheduling algorithm, or UNDEF if unknown.
+ */
+int get_scheduler(char *name) {
+
+    if (!strcmp(name, "ff")) return FF;
+    if (!strcmp(name, "rr")) return RR;
+    if (!strcmp(name, "cs")) return CS;
+    if (!strcmp(name, "mlfq")) return MLFQ;
+    if (!strcmp(name, "srtf")) return SRTF;
+    if (!strcmp(name, "cfs")) return CFS;
+    if (!strcmp(name, "ma")) return MA;
+    if (!strcmp(name, "cp")) return CP;
+    return UNDEF;
+}
+
+/*
+ * Reads the name of a memory allocation algorithm, where demand
+ * paging is named by its page replacement policy.
+ * 
+ * char *name:  u, p, v or cm, or d, lru, clock, sc, lruk or arc.
+ * int *policy: Set to the page replacement policy if demand paging,
+ *              otherwise UNDEF.
+ * 
+ * Returns int: Enumerated allocation algorithm, or UNDEF if unknown.
+ */
+int get_allocator(char *name, int *policy) {
+
+    // A policy named by an earlier option no longer applies
+    *policy = UNDEF;
+
+    if (!strcmp(name, "u")) return U;
+    if (!strcmp(name, "p")) return SWP;
+    if (!strcmp(name, "v")) return V;
+    if (!strcmp(name, "cm")) return CM;
+
+    // Demand paging with a choice of page replacement policy
+    if (!strcmp(name, "d") || !strcmp(name, "lru")) *policy = LRU;
+    else if (!strcmp(name, "clock")) *policy = CLOCK;
+    else if (!strcmp(name, "sc")) *policy = SC;
+    else if (!strcmp(name, "lruk")) *policy = LRUK;
+    else if (!strcmp(name, "arc")) *policy = ARC;
+    else return UNDEF;
+
+    return D;
+}
+
+/*
+ * Reads the name of a page reference pattern.
+ * 
+ * char *name: u (uniform), z (Zipf) or s (sequential).
+ * 
+ * Returns Access: Enumerated page reference pattern.
+ */
+Access get_access(char *name) {
 
-    fprintf(stdout, "Throughput %d, %d, %d\n", tp_avg, tp_min, tp_max);
-    fprintf(stdout, "Turnaround time %d\n", trn);
-    fprintf(stdout, "Time overhead %.2f %.2f\n", oh_max, oh_avg);
-    fprintf(stdout, "Makespan %d\n", ms);
+    if (!strcmp(name, "z")) return ZIPF;
+    if (!strcmp(name, "s")) return SEQUENTIAL;
+    return UNIFORM;
 }
 
+/*
+ * Sets an optional attribute of a process given in the
+ * form key=value after its required fields.
+ * 
+ * Process *p: Pointer to a process.
+ * char *attr: Attribute string.
+ */
+void set_attribute(Process *p, char *attr) {
+
+    char *value = strchr(attr, '=');
+
+    if (value == NULL) return;
+    *value++ = '\0';
+
+    if (!strcmp(attr, "weight") && atoi(value) > 0) p->weight = atoi(value);
+    if (!strcmp(attr, "access")) p->access = get_access(value);
+    if (!strcmp(attr, "after")) dag_parse(p, value);
+    if (!strcmp(attr, "bursts")) burst_parse(p, value);
+}
 
 /*
- * Loads processes from a file to a process table.
+ * Reads a process from a line holding its arrival time, ID, memory
+ * and job time, optionally followed by key=value attributes.
+ * 
+ * char *line: Line to read, which is changed.
+ * Process *p: Pointer to the process to initialise.
+ * 
+ * Returns int: 1 if the line held a process, 0 otherwise.
+ */
+int read_process(char *line, Process *p) {
+
+    int id, mem, offset;
+    Time t_arrived, t_job;
+    char *attr;
+
+    if (sscanf(line, "%lld %d %d %lld%n", &t_arrived, &id, &mem, &t_job, &offset) != 4) return 0;
+
+    init_process(p, id, mem, t_arrived, t_job);
+
+    // Optional attributes following the required fields
+    for (attr = strtok(line + offset, " \t\r\n"); attr; attr = strtok(NULL, " \t\r\n")) {
+        set_attribute(p, attr);
+    }
+
+    return 1;
+}
+
+/*
+ * Loads processes from a file to a process table. Each line holds
+ * the arrival time, ID, memory and job time of a process, optionally
+ * followed by key=value attributes.
  * 
  * char *filename: File containing process metadata.
  * Process *p:     Array of processes.
@@ -89,22 +269,25 @@ void print_stats(System *sys) {
  */
 int get_procs_from_file(char *filename, Process **p) {
 
-    int n = 0, id, mem, t_arrived, t_job;
+    int n = 0, size = 0;
+    char *line = NULL;
+    size_t len = 0;
     FILE *file;
 
     if ((file = fopen(filename, "r")) == NULL) exit(EXIT_FAILURE);
 
-    while (fscanf(file, "%d %d %d %d\n", &t_arrived, &id, &mem, &t_job) == 4) {
+    while (getline(&line, &len, file) != -1) {
 
-        Process *new_proc = create_process(id, mem, t_arrived, t_job);
-
-        // Expand array memory and copy data into it
-        *p = (Process*)realloc(*p, ++n * sizeof(Process));
-        memmove(*p + n - 1, new_proc, sizeof(Process));
+        // Expand array memory by doubling so each process is only copied a few times
+        if (n == size) {
+            size = max(2 * size, 1);
+            *p = (Process*)realloc(*p, size * sizeof(Process));
+        }
 
-        free(new_proc);
+        n += read_process(line, *p + n);
     }
 
+    free(line);
     fclose(file);
     return n;
 }
@@ -124,82 +307,122 @@ void notify(Notification n, System sys, int var, ...) {
 
     Process p = sys.table.p[sys.table.context];
 
-    switch (n) {
+    uint64_t formatting = sys.verifier != NULL ? profile_cycles() : 0;
+    PROFILE_START(&sys, OUTPUT);
 
-        case RUN:
+    // Nothing is printed without a stream, as for ensemble replicas
+    if (sys.out != NULL) {
 
-            // Get memory usage
-            for (int i = 0; i < sys.n_pages; i++) {
-                if (sys.pages[i].pid != UNDEF) mem++;
-            }
+        switch (n) {
+
+            case RUN:
 
-            fprintf(stdout,
-                    "%d, RUNNING, id=%d, remaining-time=%d",
-                    sys.time,
-                    p.id,
-                    p.time.remaining);
+                // Memory usage
+                mem = sys.n_used;
+
+                fprintf(sys.out,
+                        "%lld, RUNNING, id=%d, remaining-time=%lld",
+                        sys.time,
+                        p.id,
+                        p.time.remaining);
             
-            if (sys.allocator != U) {
+                if (sys.allocator != U) {
 
-                fprintf(stdout,
-                        ", load-time=%d, mem-usage=%d%%, mem-addresses=[",
-                        p.time.load,
-                        ceil(((float)mem * 100) / sys.n_pages));
+                    fprintf(sys.out,
+                            ", load-time=%lld, mem-usage=%d%%, mem-addresses=[",
+                            p.time.load,
+                            ceil(((float)mem * 100) / sys.n_pages));
                 
-                // Look through addresses to find the ones allocated to the process
-                int n = 0;
-                for (int i = 0; i < sys.n_pages; i++) {
-                    if (sys.pages[i].pid == p.id) {
+                    // Look through addresses to find the ones allocated to the process
+                    int n = 0;
+                    for (int i = frames_next_owned(sys.frames, sys.table.context, 0); i != UNDEF;
+                         i = frames_next_owned(sys.frames, sys.table.context, i + 1)) {
                         
-                        fprintf(stdout, "%d", i);
+                        fprintf(sys.out, "%d", i);
 
                         n++;
-                        if (n < p.n_pages) fprintf(stdout, ",");
+                        if (n < p.n_pages) fprintf(sys.out, ",");
                     }
+
+                    fprintf(sys.out, "]");
                 }
 
-                fprintf(stdout, "]");
-            }
+                fprintf(sys.out, "\n");
+
+                break;
 
-            fprintf(stdout, "\n");
+            case BLOCK:
+                fprintf(sys.out,
+                        "%lld, BLOCKED, id=%d, remaining-time=%lld, wake-time=%lld\n",
+                        sys.time,
+                        p.id,
+                        p.time.remaining,
+                        p.wake);
+                break;
 
-            break;
+            case FINISH:
+                fprintf(sys.out,
+                        "%lld, FINISHED, id=%d, proc-remaining=%d",
+                        sys.time,
+                        p.id,
+                        sys.table.n_alive);
+
+                if (sys.allocator == D) {
+                    fprintf(sys.out,
+                            ", faults=%d, fault-time=%lld, working-set=%d",
+                            p.faults,
+                            p.time.fault,
+                            p.ws_max);
+                }
 
-        case FINISH:
-            fprintf(stdout,
-                    "%d, FINISHED, id=%d, proc-remaining=%d\n",
-                    sys.time,
-                    p.id,
-                    sys.table.n_alive);
-            break;
+                fprintf(sys.out, "\n");
+                break;
         
-        case EVICT:
+            case EVICT:
 
-            fprintf(stdout, "%d, EVICTED, mem-addresses=[", sys.time);
+                fprintf(sys.out, "%lld, EVICTED, mem-addresses=[", sys.time);
 
-            if (n_values) {
+                if (n_values) {
 
-                fprintf(stdout, "%d", values[0]);
-                for (int i = 1; i < n_values; i++) {
-                    fprintf(stdout, ",%d", values[i]);
+                    fprintf(sys.out, "%d", values[0]);
+                    for (int i = 1; i < n_values; i++) {
+                        fprintf(sys.out, ",%d", values[i]);
+                    }
+                    fprintf(sys.out, "]\n");
                 }
-                fprintf(stdout, "]\n");
-            }
 
-        default:
-            break;
+            default:
+                break;
+        }
+
+        // Sent on as soon as it is decided when online
+        if (sys.online != NULL) online_decided(&sys);
     }
 
+    PROFILE_STOP(&sys, OUTPUT);
+    verify_output(&sys, formatting);
+
     // malloc'd memory used for var arg
     if (values != NULL) free(values);
 }
 
 int main(int argc, char **argv) {
     
-    int opt, n, mem_size = UNDEF, quantum = UNDEF;
+    int opt, n, mem_size = UNDEF, quantum = UNDEF, levels = UNDEF, boost = UNDEF,
+        granularity = UNDEF, aging = UNDEF, batch = 0, bandwidth = 0, prefetch = 0, percentiles = 0,
+        fragmentation = 0, compaction = UNDEF, evict_blocked = 0;
+    Time checkpoint = UNDEF;
+    int policy = UNDEF, proc_scheduler = UNDEF, mem_allocator = UNDEF;
+    char *access = NULL, *seed = NULL, *checkpoint_file = NULL, *restore_file = NULL;
+    char *golden = NULL, *series_file = NULL;
+    int interval = EPOCH;
+    double baseline = 0, admission = 0;
+    int timing = 0, counters = 0;
+    int replicas = 0, threads = 0;
+    Noise noise = {ENSEMBLE_JOB_NOISE, 0, 0};
+    char *grid = NULL, *queue = NULL, *online = NULL;
+    clock_t start = clock();
     char *filename;
-    Scheduler proc_scheduler;
-    Allocator mem_allocator;
     Process *p = NULL;
     System *sys = NULL;
 
@@ -211,31 +434,174 @@ int main(int argc, char **argv) {
                 strcpy(filename, optarg);
                 break;
 
-            case 'a':
-                if (!strcmp(optarg, "ff")) proc_scheduler = FF;
-                if (!strcmp(optarg, "rr")) proc_scheduler = RR;
-                if (!strcmp(optarg, "cs")) proc_scheduler = CS;
-                break;
-            
-            case 'm':
-                if (!strcmp(optarg, "u")) mem_allocator = U;
-                if (!strcmp(optarg, "p")) mem_allocator = SWP;
-                if (!strcmp(optarg, "v")) mem_allocator = V;
-                if (!strcmp(optarg, "cm")) mem_allocator = CM;
-                break;
+            case 'a': proc_scheduler = get_scheduler(optarg); break;
+            case 'm': mem_allocator = get_allocator(optarg, &policy); break;
             
             case 's': mem_size = atoi(optarg); break;
             case 'q': quantum = atoi(optarg); break;
+            case 'l': levels = atoi(optarg); break;
+            case 'b': boost = atoi(optarg); break;
+            case 'g': granularity = atoi(optarg); break;
+            case 'w': aging = atoi(optarg); break;
+            case 'B': batch = 1; break;
+            case 'p': access = optarg; break;
+            case 'S': seed = optarg; break;
+            case 'i': bandwidth = atoi(optarg); break;
+            case 'P': prefetch = 1; break;
+            case 'F': fragmentation = 1; break;
+            case 'c': compaction = max(atoi(optarg), 0); break;
+            case 'L': percentiles = 1; break;
+
+            // Pages of a process are evicted as soon as it blocks for I/O
+            case 'e': evict_blocked = 1; break;
+
+            // Processes wait to be admitted while memory is committed past this ratio of its size
+            case 'R': admission = atof(optarg); break;
+
+            // Checkpoint given as time:file
+            case 'k':
+                checkpoint = atoll(optarg);
+                checkpoint_file = strchr(optarg, ':');
+                if (checkpoint_file != NULL) checkpoint_file++;
+                break;
+
+            case 'r': restore_file = optarg; break;
+
+            // Golden output to verify against, and its CPU time
+            case 'V': golden = optarg; break;
+            case 'T': baseline = atof(optarg); break;
+            case 'x': timing = 1; break;
+            case 'v': counters = 1; break;
+
+            // Samples written every interval as the OS runs
+            case 'o': series_file = optarg; break;
+            case 't': interval = atoi(optarg); break;
+
+            // Ensemble of perturbed replicas, noise given as job,mem,arrival
+            case 'E': replicas = atoi(optarg); break;
+            case 'N': ensemble_noise(&noise, optarg); break;
+            case 'j': threads = atoi(optarg); break;
+
+            // Sweep over a grid through a work queue, or work on one only
+            case 'G': grid = optarg; break;
+            case 'W': queue = optarg; break;
+
+            // Processes read as they arrive, from stdin (-) or a socket
+            case 'O': online = optarg; break;
         }
     }
 
-    n = get_procs_from_file(filename, &p);
-    sys = start(p, n, proc_scheduler, mem_allocator, mem_size, quantum);
+    if (grid != NULL || queue != NULL) {
+
+        if (grid != NULL) {
+            Grid *g = grid_init(grid);
+            sweep(queue != NULL ? queue : SWEEP_DIR, g, threads);
+            grid_free(g);
+        } else {
+            sweep_work(queue);
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    if (restore_file != NULL) {
+
+        // Continue a checkpointed OS, with any algorithms and settings given replacing its own
+        sys = restore(restore_file, &p);
+
+        if (proc_scheduler != UNDEF) sys->scheduler = proc_scheduler;
+        if (mem_allocator != UNDEF) sys->allocator = mem_allocator;
+        if (quantum != UNDEF) sys->quantum = quantum;
+        sys->batch = sys->batch || batch;
+        if (bandwidth || prefetch) sys->bandwidth = bandwidth;
+        sys->prefetch = sys->prefetch || prefetch;
+        sys->fragmentation = sys->fragmentation || fragmentation;
+        if (compaction != UNDEF) sys->compaction = compaction;
+        sys->percentiles = sys->percentiles || percentiles;
+        sys->evict_blocked = sys->evict_blocked || evict_blocked;
+
+    } else {
+
+        n = online != NULL ? 0 : get_procs_from_file(filename, &p);
+        sys = create_system(p, n, proc_scheduler, mem_allocator, mem_size, quantum);
+
+        sys->batch = batch;
+        sys->bandwidth = bandwidth;
+        sys->prefetch = prefetch;
+        sys->fragmentation = fragmentation;
+        sys->compaction = compaction;
+        sys->percentiles = percentiles;
+        sys->evict_blocked = evict_blocked;
+    }
+
+    // Demand paging loads every page into a frame, so needs at least one
+    if (sys->allocator == D && sys->mem_size < PAGE_SIZE) {
+        fprintf(stderr, "Demand paging needs at least %dKB of memory, given with -s\n", PAGE_SIZE);
+        exit(EXIT_FAILURE);
+    }
+
+    // Optional algorithm specific settings
+    if (levels > 0) sys->levels = levels;
+    if (boost != UNDEF) sys->boost = boost;
+    if (granularity > 0) sys->granularity = granularity;
+    if (aging != UNDEF) sys->aging = aging;
+    if (access != NULL) sys->access = get_access(access);
+    if (seed != NULL) sys->seed = strtoull(seed, NULL, 10);
+    if (policy != UNDEF) sys->policy = policy;
+    if (admission > 0) sys->admission = admission;
+
+    // Prefetching needs pages to load in the background
+    sys->bandwidth = sys->prefetch ? max(sys->bandwidth, 1) : max(sys->bandwidth, 0);
+
+    if (online != NULL && sys->snapshot == NULL) online_init(sys, online);
+
+    if (checkpoint_file != NULL) {
+        sys->checkpoint = checkpoint;
+        sys->checkpoint_file = checkpoint_file;
+    }
+
+    // Replicas are run in place of the OS, which is never run itself
+    if (replicas > 0 && sys->snapshot == NULL) {
+
+        ensemble(sys, replicas, noise, threads);
+
+        dag_free_edges(p, sys->table.n);
+        burst_free_lists(p, sys->table.n);
+        free(sys->table.states);
+        free(p);
+        free(sys);
+
+        return EXIT_SUCCESS;
+    }
+
+    if (counters) profile_init(sys);
+    if (series_file != NULL) series_init(sys, series_file, interval);
+
+    // Time taken to load the processes is reported with the rest of the run
+    if (golden != NULL || timing) {
+        verify_init(sys, golden, baseline, (double)(clock() - start) / CLOCKS_PER_SEC);
+    }
+
+    run(sys);
     print_stats(sys);
 
-    free(p);
+    int result = sys->verifier != NULL ? verify(sys) : EXIT_SUCCESS;
+
+    profile_free(sys);
+    series_free(sys);
+
+    store_free(sys);
+    frag_free(sys);
+    stats_free(sys);
+    online_free(sys);
+
+    // The process table may have grown while online
+    dag_free_edges(sys->table.p, sys->table.n);
+    burst_free_lists(sys->table.p, sys->table.n);
+    free(sys->table.states);
+    free(sys->table.p);
     free(sys);
 
-    return 0;
+    return result;
 }
 
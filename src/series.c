@@ -0,0 +1,147 @@
+/*
+ * series.c
+ *
+ * Periodic samples of the load on the OS written to a file as it
+ * runs, taken from counters kept as the OS changes rather than by
+ * scanning. Written for project 2 of COMP30023 Computer Systems,
+ * semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "series.h"
+
+/*
+ * Starts sampling an OS, from its current time.
+ *
+ * System *sys:    Pointer to an OS struct.
+ * char *filename: File to write samples to.
+ * int interval:   Time between samples.
+ */
+void series_init(System *sys, char *filename, int interval) {
+
+    Series *s = (Series*)calloc(1, sizeof(Series));
+    size_t len = strlen(filename), ext = strlen(SERIES_BINARY);
+
+    s->binary = len >= ext && !strcmp(filename + len - ext, SERIES_BINARY);
+
+    if ((s->file = fopen(filename, s->binary ? "wb" : "w")) == NULL) exit(EXIT_FAILURE);
+
+    s->interval = max(interval, 1);
+    s->next = (sys->time / s->interval + 1) * s->interval;
+    s->run_start = s->run_end = sys->time;
+
+    if (!s->binary) fprintf(s->file, "time,ready,resident,memory,loads,busy\n");
+
+    sys->series = s;
+}
+
+/*
+ * Writes every sample due before the given time. The OS must not
+ * have changed since the time of the earliest of them, other than
+ * by processes arriving that have not been received yet.
+ *
+ * System *sys: Pointer to an OS struct.
+ * Time until:  Time to write samples up to.
+ */
+static void write_samples(System *sys, Time until) {
+
+    long long busy;
+    int next = sys->table.next, ready;
+
+    // Shorthand
+    Series *s = sys->series;
+
+    if (s == NULL) return;
+
+    // Every sample until the current time shows the same state
+    Sample sample = {
+        .ready = max(sys->table.n_alive - (sys->status == RUNNING) -
+                     (sys->store != NULL ? sys->store->waiting : 0) -
+                     (sys->waiting != NULL ? sys->waiting->n : 0), 0),
+        .resident = sys->n_resident,
+        .loads = sys->store != NULL ? sys->store->queue->n : 0,
+        .memory = sys->n_pages ? (float)sys->n_used * 100 / sys->n_pages : 0
+    };
+
+    ready = sample.ready;
+
+    for (; s->next < until; s->next += s->interval) {
+
+        // Processes arriving during a run are only received once it ends
+        while (next < sys->table.n && sys->table.p[next].time.arrived <= s->next) {
+            if (sys->pending == NULL && !dag_blocked(sys, next)) ready++;
+            next++;
+        }
+        sample.ready = ready;
+
+        // Time running up to the sample, only the latest run may overlap it
+        busy = s->busy + min(max(s->next - s->run_start, 0), s->run_end - s->run_start);
+
+        sample.time = s->next;
+        sample.busy = (float)(busy - s->sampled) / s->interval;
+        s->sampled = busy;
+
+        if (s->binary) {
+            fwrite(&sample, sizeof(Sample), 1, s->file);
+        } else {
+            fprintf(s->file, "%lld,%d,%d,%.2f,%d,%.2f\n", sample.time, sample.ready,
+                    sample.resident, sample.memory, sample.loads, sample.busy);
+        }
+    }
+}
+
+/*
+ * Writes any samples due up to the current time and stops sampling.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void series_free(System *sys) {
+
+    if (sys->series == NULL) return;
+
+    // The last sample is at the time the OS stopped
+    write_samples(sys, sys->time + 1);
+
+    fclose(sys->series->file);
+    free(sys->series);
+
+    sys->series = NULL;
+}
+
+/*
+ * Writes every sample due before the current time. The OS must not
+ * have changed since the time of the earliest of them.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void series_sample(System *sys) {
+
+    write_samples(sys, sys->time);
+}
+
+/*
+ * Records that the process in the current context ran from the
+ * given time until the current time, and writes samples due.
+ *
+ * System *sys: Pointer to an OS struct.
+ * Time start:  Time the process started running.
+ */
+void series_run(System *sys, Time start) {
+
+    // Shorthand
+    Series *s = sys->series;
+
+    if (s == NULL) return;
+
+    // Samples before the previous run ended have been written already
+    s->busy += s->run_end - s->run_start;
+    s->run_start = start;
+    s->run_end = sys->time;
+
+    series_sample(sys);
+}
@@ -8,8 +8,6 @@
  * Author: Brodie Daff
  *         bdaff@student.unimelb.edu.au
  */
-#include <stdlib.h>
-
 #include "sjf.h"
 
 /*
@@ -28,28 +26,22 @@ int compare_job(const void* a, const void* b) {
 }
 
 /*
- * Updates the current context for the system based
- * on sorting of the process table.
+ * Updates the current context for the system to be the
+ * received process with the shortest job time.
  * 
  * System *sys: Pointer to an OS struct.
  * 
  * returns Status: Enumerated status flag.
  */
 Status cs_context(System *sys) {
-    
-    // Shorthand
-    Process *p = sys->table.p;
-
-    // Set context to be the next immediately available process
-    for (int i = 0; i < sys->table.n; i++) {
-        if (p[i].status == START || p[i].status == READY) {
-            sys->table.context = i;
-            return READY;
-        }
-    }
 
     // No valid process found
-    return TERMINATED;
+    if (!sys->ready->n) return TERMINATED;
+
+    // Ready heap is ordered by job time
+    sys->table.context = heap_pop(sys->ready);
+
+    return READY;
 }
 
 /*
@@ -60,21 +52,22 @@ Status cs_context(System *sys) {
  */
 void cs_step(System *sys) {
 
-    // Sort processes by job time
-    qsort(sys->table.p, sys->table.n, sizeof(Process), compare_job);
-    
+    Time runtime;
+    Process *p = NULL;
+
     switch (sys->status) {
 
         // New process
         case READY:
 
             // Update current context, or stop running if no processes available
-            if (cs_context(sys) == TERMINATED) {
+            if (profile_context(sys, cs_context) == TERMINATED) {
                 sys->status = TERMINATED;
                 break;
             } 
 
-            process_start(sys);
+            // Dispatch another process while its pages load
+            if (process_start(sys) == LOADING) break;
 
             sys->status = RUNNING;
 
@@ -82,10 +75,19 @@ void cs_step(System *sys) {
         
         case RUNNING:
 
-            // Advance clock by job time as it will run to completion
-            sys->time += sys->table.p[sys->table.context].time.job;
+            // Shorthand
+            p = &sys->table.p[sys->table.context];
+
+            // Advance clock by time remaining as it will run to completion, or until it blocks
+            runtime = burst_limit(sys, p->time.remaining);
+            process_run(sys, runtime);
 
-            process_finish(sys);
+            // Other processes run while it waits for I/O
+            if (p->time.remaining - runtime) {
+                process_pause(sys);
+            } else {
+                process_finish(sys);
+            }
 
             sys->status = READY;
 
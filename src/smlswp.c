@@ -30,41 +30,64 @@ int compare_size(const void *a, const void *b) {
 }
 
 /*
- * Performs memory swapping with the goal of keeping the entirety of
- * smaller processes in memory and only forcing the largest processes
- * to use virtual memory.
+ * Finds the number of pages the process in the current context is
+ * given, being the surplus pages held by larger ready processes,
+ * but at least enough to begin running.
  * 
  * System *sys: Pointer to an OS struct.
+ * 
+ * Returns int: Number of pages it needs in memory to run.
  */
-void smallswap(System *sys) {
+int smallswap_target(System *sys) {
 
-    int *candidates = NULL, n_candidates = 0, target = 0;
+    int target = 0, n_ready = 0;
 
     // Shorthand
     Process *p = &sys->table.p[sys->table.context];
 
-    // Copy of processes sorted by size
-    Process *sorted = (Process*)malloc(sys->table.n * sizeof(Process));
-    memmove(sorted, sys->table.p, sys->table.n * sizeof(Process));
-    qsort(sorted, sys->table.n, sizeof(Process), compare_size);
+    // Ready processes sorted by size
+    Process **ready = (Process**)malloc(sys->table.n * sizeof(Process*));
+    for (int i = 0; i < sys->table.n; i++) {
+        if (sys->table.states[i] == READY) ready[n_ready++] = &sys->table.p[i];
+    }
+    sort_processes(ready, n_ready, compare_size);
 
     // Get surplus page count
-    for (int i = 0; i < sys->table.n && target < (p->mem / sys->page_size); i++) {
-
-        if (sorted[i].status != READY) continue;
+    for (int i = 0; i < n_ready && target < (p->mem / sys->page_size); i++) {
 
         // Only count processes larger than the one in context
-        if (sorted[i].id == p->id) break;
+        if (ready[i]->id == p->id) break;
 
-        target += sorted[i].n_pages - MIN_PAGES;
+        target += ready[i]->n_pages - MIN_PAGES;
     }
 
-    p->time.load = 0;
+    free(ready);
 
-    candidates = (int*)calloc(1, (p->mem / sys->page_size) * sizeof(int));
+    return min(max(target, MIN_PAGES), (p->mem / sys->page_size));
+}
+
+/*
+ * Performs memory swapping with the goal of keeping the entirety of
+ * smaller processes in memory and only forcing the largest processes
+ * to use virtual memory.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void smallswap(System *sys) {
+
+    int *candidates = NULL, n_candidates = 0, target, n_sorted;
+
+    // Shorthand
+    Process *p = &sys->table.p[sys->table.context];
 
-    target = min(max(target, MIN_PAGES), (p->mem / sys->page_size));
+    target = smallswap_target(sys);
 
+    // Processes with pages in memory sorted by size
+    Process **sorted = resident(sys, compare_size, &n_sorted);
+
+    p->time.load = 0;
+
+    candidates = (int*)calloc(1, (p->mem / sys->page_size) * sizeof(int));
 
     while (p->n_pages < target) {
         
@@ -73,17 +96,9 @@ void smallswap(System *sys) {
 
         if (p->n_pages < target) {
             
-            // Iterate on sorted array
-            for (int i = 0; i < sys->table.n; i++) {
-
-                // Iterate on pages
-                for (int j = 0; j < sys->n_pages && n_candidates < (target - p->n_pages); j++) {
-                    if (sys->pages[j].pid == sorted[i].id && sys->pages[j].pid != p->id) {
-                        candidates[n_candidates] = j;
-                        n_candidates++;
-                    }
-                }
-            }
+            // Find evictable pages in sorted array
+            n_candidates = find_victims(sys, sorted, n_sorted, candidates, n_candidates,
+                                        target - p->n_pages);
 
             // Sort in increasing order of memory address
             qsort(candidates, n_candidates, sizeof(int), compare_int);
@@ -92,9 +107,6 @@ void smallswap(System *sys) {
         }
     }
 
-    // Increase remaining time for page fault
-    p->time.remaining += (p->mem / PAGE_SIZE) - p->n_pages;
-
     free(candidates);
     free(sorted);
 }
@@ -0,0 +1,131 @@
+/*
+ * srtf.c
+ * 
+ * A preemptive Shortest-Remaining-Time-First process scheduling
+ * algorithm to run for a process scheduling simulator. Written
+ * for project 2 of COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include "srtf.h"
+
+/*
+ * qsort comparison function for process remaining time.
+ */
+int compare_remaining(const void *a, const void *b) {
+
+    const Process *p1 = a, *p2 = b;
+
+    if (p1->time.remaining < p2->time.remaining) return -1;
+    if (p1->time.remaining == p2->time.remaining) {
+        if (p1->id < p2->id) return -1;
+        if (p1->id == p2->id) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Updates the current context for the system to be the
+ * received process with the least time remaining.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * 
+ * returns Status: Enumerated status flag.
+ */
+Status srtf_context(System *sys) {
+
+    // No valid process found
+    if (!sys->ready->n) return TERMINATED;
+
+    // Ready heap is ordered by time remaining
+    sys->table.context = heap_pop(sys->ready);
+
+    return READY;
+}
+
+/*
+ * Handles a clock cycle for the OS according to
+ * Shortest-Remaining-Time-First scheduling.
+ * 
+ * System *sys: Pointer to the OS.
+ */
+void srtf_step(System *sys) {
+
+    Time left, burst, arrival, wake;
+    Process *p = NULL;
+    Status dispatched;
+
+    switch (sys->status) {
+
+        // New process
+        case READY:
+
+            // Update current context, or stop running if no processes available
+            if (profile_context(sys, srtf_context) == TERMINATED) {
+                sys->status = TERMINATED;
+                break;
+            }
+
+            if (sys->table.states[sys->table.context] == START) {
+                dispatched = process_start(sys);
+            } else {
+                dispatched = process_resume(sys);
+            }
+
+            // Dispatch another process while its pages load
+            if (dispatched == LOADING) break;
+
+            sys->status = RUNNING;
+
+            break;
+
+        case RUNNING:
+
+            // Shorthand
+            p = &sys->table.p[sys->table.context];
+
+            // Time left excluding what has been run since it was last dispatched
+            left = p->time.remaining - (sys->time - p->time.last - p->time.load);
+            burst = burst_limit(sys, left);
+            arrival = next_arrival(*sys);
+
+            // Processes waking from I/O may preempt it too
+            wake = burst_next(sys);
+            if (wake != UNDEF && (arrival == UNDEF || wake < arrival)) arrival = wake;
+
+            // Run to completion, or until it blocks, if nothing will arrive before then
+            if (arrival == UNDEF || arrival >= sys->time + burst) {
+
+                process_run(sys, burst);
+
+                if (burst < left) {
+                    process_pause(sys);
+                } else {
+                    process_finish(sys);
+                }
+
+                sys->status = READY;
+
+                break;
+            }
+
+            // Otherwise run until the next arrival and receive it
+            process_run(sys, arrival - sys->time);
+            get_processes(sys);
+
+            // Preempt if a newly received process is shorter
+            if (sys->ready->n && sys->table.p[sys->ready->items[0]].time.remaining < left) {
+
+                process_pause(sys);
+                heap_push(sys->ready, sys->table.context);
+
+                sys->status = READY;
+            }
+
+            break;
+
+        default: break;
+    }
+}
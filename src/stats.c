@@ -0,0 +1,186 @@
+/*
+ * stats.c
+ *
+ * Statistics of finished processes, gathered as each one finishes
+ * so that none need the process table afterwards, with quantile
+ * sketches for the tails of their distributions. Written for
+ * project 2 of COMP30023 Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+#include <limits.h>
+
+#include "stats.h"
+
+/*
+ * Finds the bucket of a sketch holding a value.
+ */
+static int bucket(long long value) {
+
+    int shift = 0;
+
+    if (value < 2 * SKETCH_SUB) return (int)value;
+
+    // Keep the highest SKETCH_BITS + 1 bits of the value
+    while ((value >> shift) >= 2 * SKETCH_SUB) shift++;
+
+    return shift * SKETCH_SUB + (int)(value >> shift);
+}
+
+/*
+ * Finds the middle of the range of values held by a bucket.
+ */
+static long long bucket_value(int b) {
+
+    int shift;
+    long long low;
+
+    if (b < 2 * SKETCH_SUB) return b;
+
+    shift = b / SKETCH_SUB - 1;
+    low = (long long)(b - shift * SKETCH_SUB) << shift;
+
+    return low + (((long long)1 << shift) - 1) / 2;
+}
+
+/*
+ * Adds a value to a sketch.
+ *
+ * Sketch *s:      Pointer to a sketch.
+ * long long value: Value to add, negative values are counted as 0.
+ */
+void sketch_add(Sketch *s, long long value) {
+
+    s->counts[bucket(max(value, 0))]++;
+    s->n++;
+}
+
+/*
+ * Adds every value in one sketch to another.
+ *
+ * Sketch *to:   Pointer to the sketch to add to.
+ * Sketch *from: Pointer to the sketch to add.
+ */
+void sketch_merge(Sketch *to, Sketch *from) {
+
+    for (int b = 0; b < SKETCH_BUCKETS; b++) to->counts[b] += from->counts[b];
+    to->n += from->n;
+}
+
+/*
+ * Finds the value at a quantile of a sketch.
+ *
+ * Sketch *s: Pointer to a sketch.
+ * double q:  Quantile between 0 and 1.
+ *
+ * Returns long long: Middle of the bucket holding the quantile, or 0
+ *                    if the sketch is empty.
+ */
+long long sketch_quantile(Sketch *s, double q) {
+
+    long long rank = (long long)(q * s->n), seen = 0;
+
+    // Smallest value with at least the rank below or at it
+    if (rank < q * s->n) rank++;
+    rank = max(rank, 1);
+
+    for (int b = 0; b < SKETCH_BUCKETS; b++) {
+        if ((seen += s->counts[b]) >= rank) return bucket_value(b);
+    }
+
+    return 0;
+}
+
+/*
+ * Allocates statistics for an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void stats_init(System *sys) {
+
+    Stats *s = (Stats*)calloc(1, sizeof(Stats));
+
+    s->tp_min = INT_MAX;
+
+    sys->stats = s;
+}
+
+/*
+ * Frees the statistics of an OS.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void stats_free(System *sys) {
+
+    free(sys->stats);
+    sys->stats = NULL;
+}
+
+/*
+ * Counts the epoch being counted and any empty epochs after it,
+ * moving on to the given epoch if it is later.
+ */
+static void next_epoch(Stats *s, long long until) {
+
+    if (s->epoch >= until) return;
+
+    s->tp_min = min(s->epoch_finished, s->tp_min);
+    s->tp_max = max(s->epoch_finished, s->tp_max);
+    s->tp_total += s->epoch_finished;
+
+    // Epochs in between had nothing finish, so are counted at once
+    if (until - s->epoch > 1) s->tp_min = 0;
+
+    s->epochs += until - s->epoch;
+    s->epoch = until;
+    s->epoch_finished = 0;
+}
+
+/*
+ * Records a process that has just finished.
+ *
+ * System *sys: Pointer to an OS struct.
+ * Process *p:  Pointer to the process.
+ */
+void stats_finish(System *sys, Process *p) {
+
+    // Shorthand
+    Stats *s = sys->stats;
+
+    Time turnaround = p->time.finished - p->time.arrived, queueing = p->time.admitted - p->time.arrived;
+    float overhead = (float)turnaround / p->time.job;
+
+    // Epochs end just after each multiple of EPOCH
+    next_epoch(s, (long long)(p->time.finished / (EPOCH + 0.01)));
+    s->epoch_finished++;
+
+    s->turnaround_total += turnaround;
+    s->overhead_total += overhead;
+    s->overhead_max = overhead > s->overhead_max ? overhead : s->overhead_max;
+    s->makespan = max(p->time.finished, s->makespan);
+    s->queueing_total += queueing;
+    s->queueing_max = max(queueing, s->queueing_max);
+    s->cpu_total += p->time.job;
+
+    sketch_add(&s->turnaround, turnaround);
+    sketch_add(&s->waiting, turnaround - p->time.job);
+    sketch_add(&s->overhead, (long long)(overhead * 100 + 0.5));
+    sketch_add(&s->queueing, queueing);
+}
+
+/*
+ * Counts every epoch up to the makespan, which must be called once
+ * every process has finished.
+ *
+ * System *sys: Pointer to an OS struct.
+ */
+void stats_close(System *sys) {
+
+    // Shorthand
+    Stats *s = sys->stats;
+
+    next_epoch(s, ceil_div(s->makespan, EPOCH));
+}
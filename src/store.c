@@ -0,0 +1,267 @@
+/*
+ * store.c
+ * 
+ * A backing store that loads pages into memory in the background
+ * with a bounded bandwidth, so that other processes may run while
+ * a process waits for its pages. Written for project 2 of
+ * COMP30023 Computer Systems, semester 1 2020.
+ * 
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+
+#include "store.h"
+
+/*
+ * Allocates a backing store for an OS.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void store_init(System *sys) {
+
+    Store *s = (Store*)calloc(1, sizeof(Store));
+
+    s->queue = create_queue(sys->table.n);
+    s->bandwidth = sys->bandwidth;
+    s->prefetch = sys->prefetch;
+    s->free = sys->time;
+
+    sys->store = s;
+}
+
+/*
+ * Frees the backing store of an OS.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void store_free(System *sys) {
+
+    if (sys->store == NULL) return;
+
+    free_queue(sys->store->queue);
+    free(sys->store);
+
+    sys->store = NULL;
+}
+
+/*
+ * Checks whether a process' pages are being transferred, or have
+ * been transferred but not yet used, in which case they may not
+ * be evicted.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int i:       Index in the process table of the process.
+ * 
+ * Returns int: Evaluates to true if the pages are pinned.
+ */
+int pinned(System *sys, int i) {
+
+    // Shorthand
+    Time io = sys->table.p[i].io;
+
+    // Loaded pages are kept for the process until it runs, unless the CPU stalled
+    return io != UNDEF && (io > sys->time || !sys->store->stalled);
+}
+
+/*
+ * Makes sure the process in the current context can be given the
+ * pages it needs without evicting pages being transferred, waiting
+ * for the backing store to finish every transfer if not.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * 
+ * Returns int: Evaluates to true if the CPU stalled waiting.
+ */
+int store_reserve(System *sys) {
+
+    int need, available;
+
+    // Shorthand
+    Store *s = sys->store;
+    Process *p = &sys->table.p[sys->table.context];
+
+    if (s == NULL) return 0;
+
+    // Virtual memory and Swapping-Small only need the pages they will be given
+    need = p->mem / sys->page_size;
+    if (sys->allocator == V) need = min(need, MIN_PAGES);
+    if (sys->allocator == CM) need = smallswap_target(sys);
+    need -= p->n_pages;
+
+    if (need <= 0) return 0;
+
+    available = sys->n_pages - sys->n_used;
+
+    for (int i = 0; i < sys->n_pages && available < need; i++) {
+        if (sys->frames->owner[i] != UNDEF && sys->frames->owner[i] != sys->table.context &&
+            !pinned(sys, sys->frames->owner[i])) available++;
+    }
+
+    if (available >= need) return 0;
+
+    // Nothing else can be evicted until the transfers in flight finish
+    sys->time = max(sys->time, s->free);
+    store_poll(sys);
+
+    s->stalled = 1;
+
+    return 1;
+}
+
+/*
+ * Queues a transfer of pages on the backing store.
+ * 
+ * Store *s:  Pointer to a backing store.
+ * int pages: Number of pages to transfer.
+ * Time time: Time of the request.
+ * 
+ * Returns Time: Time the transfer finishes.
+ */
+static Time transfer(Store *s, int pages, Time time) {
+
+    int duration = ((pages + s->bandwidth - 1) / s->bandwidth) * PAGE_LOAD_TIME;
+
+    s->free = max(s->free, time) + duration;
+    s->busy += duration;
+    s->requests++;
+
+    // Transfers still outstanding, including this one
+    s->depth_total += s->queue->n + 1;
+    s->depth_max = max(s->depth_max, s->queue->n + 1);
+
+    return s->free;
+}
+
+/*
+ * Records a process as waiting on a transfer until the given time.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int i:       Index in the process table of the process.
+ * Time done:   Time the transfer finishes.
+ */
+static void await(System *sys, int i, Time done) {
+
+    sys->table.p[i].io = done;
+    enqueue(sys->store->queue, i);
+}
+
+/*
+ * Requests the pages just allocated to the process in the current
+ * context from the backing store. The process waits in the LOADING
+ * state unless the CPU has already stalled for the backing store,
+ * in which case it waits for the pages as its load time.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * int stalled: Flag for the CPU having stalled for the backing store.
+ * 
+ * Returns Status: LOADING if the process must wait, RUNNING otherwise.
+ */
+Status store_load(System *sys, int stalled) {
+
+    Time done;
+
+    // Shorthand
+    Store *s = sys->store;
+    Process *p = &sys->table.p[sys->table.context];
+
+    if (s == NULL) return RUNNING;
+
+    s->stalled = 0;
+
+    if (!p->time.load) return RUNNING;
+
+    done = transfer(s, (int)(p->time.load / PAGE_LOAD_TIME), sys->time);
+
+    // Waiting again would give up the memory just freed for it
+    if (stalled) {
+        p->time.load = done - sys->time;
+        return RUNNING;
+    }
+
+    p->time.load = 0;
+    sys->table.states[sys->table.context] = LOADING;
+    s->waiting++;
+    await(sys, sys->table.context, done);
+
+    return LOADING;
+}
+
+/*
+ * Loads pages of the process scheduled to run next into free
+ * memory while the process in the current context runs.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void store_prefetch(System *sys) {
+
+    int i, before, context = sys->table.context;
+
+    // Shorthand
+    Store *s = sys->store;
+    Process *p = NULL;
+
+    if (s == NULL || !s->prefetch || sys->n_used == sys->n_pages) return;
+
+    if ((i = upcoming(sys)) == UNDEF || i == context) return;
+
+    p = &sys->table.p[i];
+
+    if (p->io != UNDEF || p->n_pages >= p->mem / sys->page_size) return;
+
+    // Only free pages are used so nothing is evicted early
+    before = p->n_pages;
+    sys->table.context = i;
+    allocate(sys, p->mem / sys->page_size);
+    sys->table.context = context;
+
+    if (p->n_pages == before) return;
+
+    s->prefetched += p->n_pages - before;
+    await(sys, i, transfer(s, p->n_pages - before, sys->time));
+}
+
+/*
+ * Receives finished transfers, handing processes that were waiting
+ * for them back to the scheduling algorithm.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void store_poll(System *sys) {
+
+    int i;
+
+    // Shorthand
+    Store *s = sys->store;
+    Process *p = NULL;
+
+    while (s->queue->n && sys->table.p[s->queue->items[s->queue->head]].io <= sys->time) {
+
+        i = dequeue(s->queue);
+        p = &sys->table.p[i];
+
+        // Prefetched processes never left the scheduling algorithm
+        if (sys->table.states[i] == LOADING) {
+            sys->table.states[i] = p->time.started == UNDEF ? START : READY;
+            s->waiting--;
+            requeue(sys, i);
+
+            sys->status = sys->status == TERMINATED ? READY : sys->status;
+        }
+    }
+}
+
+/*
+ * Finds when the next transfer will finish.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * 
+ * Returns Time: Time the next transfer finishes, or UNDEF if none.
+ */
+Time store_next(System *sys) {
+
+    if (sys->store == NULL || !sys->store->queue->n) return UNDEF;
+
+    return sys->table.p[sys->store->queue->items[sys->store->queue->head]].io;
+}
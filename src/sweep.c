@@ -0,0 +1,618 @@
+/*
+ * sweep.c
+ *
+ * Sweeps over a grid of traces, algorithms and settings, split into
+ * shards that workers claim from a work queue of files in a shared
+ * directory, so that workers may run on any machine that can see it.
+ * Results are kept with the queue, so a sweep stopped part way is
+ * resumed by running it again. Written for project 2 of COMP30023
+ * Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "sweep.h"
+
+// Longest statistic kept for the table
+#define SWEEP_VALUE 32
+
+// Names of the axes in a grid file, and the values of those not given
+static char *axes[N_AXES] = {"trace", "scheduler", "allocator", "memory", "quantum"};
+static char *defaults[N_AXES] = {NULL, "ff", "u", "0", NULL};
+
+// Shards waiting for a worker, being run, and with results
+static char *queues[] = {"todo", "claimed", "done"};
+
+// Statistics printed for each run that are kept for the table, and their columns
+#define N_RESULTS 4
+static char *results[N_RESULTS] = {"Throughput ", "Turnaround time ", "Time overhead ", "Makespan "};
+static char *columns[N_AXES + N_RESULTS] = {
+    "Trace", "Scheduler", "Allocator", "Memory", "Quantum",
+    "Throughput", "Turnaround", "Overhead", "Makespan"
+};
+
+/*
+ * Adds a value to an axis of a grid.
+ */
+static void add_value(Grid *g, Axis a, char *value) {
+
+    g->values[a] = (char**)realloc(g->values[a], (g->n[a] + 1) * sizeof(char*));
+    g->values[a][g->n[a]++] = strdup(value);
+}
+
+/*
+ * Finds the least memory an allocator needs to run every process
+ * of a trace, given the largest process in it. Less makes it evict
+ * forever.
+ */
+static int least_memory(int allocator, int largest) {
+
+    switch (allocator) {
+        case U: return 0;
+        case SWP: return largest;
+        case V: case CM: return min(largest, MIN_MEM);
+        default: return PAGE_SIZE;
+    }
+}
+
+/*
+ * Reads a grid from a file, where each line names an axis followed by
+ * its values, as trace, scheduler, allocator, memory or quantum, or
+ * gives the number of runs in each shard, as shard. Every value is
+ * checked, including that each memory size is enough for every
+ * allocator to run the largest process of each trace, and axes not
+ * given have the value used by default.
+ *
+ * char *filename: File containing the grid.
+ *
+ * Returns Grid*: Pointer to the new grid.
+ */
+Grid *grid_init(char *filename) {
+
+    Grid *g = (Grid*)calloc(1, sizeof(Grid));
+    char *line = NULL, *key, *value, quantum[16];
+    size_t len = 0;
+    int a, policy, n, largest, memory;
+    Process *p = NULL;
+    FILE *file;
+
+    if ((file = fopen(filename, "r")) == NULL) exit(EXIT_FAILURE);
+
+    g->shard = SWEEP_SHARD;
+
+    while (getline(&line, &len, file) != -1) {
+
+        if ((key = strtok(line, " \t\r\n")) == NULL) continue;
+
+        if (!strcmp(key, "shard")) {
+            if ((value = strtok(NULL, " \t\r\n")) != NULL && atoi(value) > 0) g->shard = atoi(value);
+            continue;
+        }
+
+        for (a = 0; a < N_AXES && strcmp(key, axes[a]); a++);
+        if (a == N_AXES) continue;
+
+        while ((value = strtok(NULL, " \t\r\n")) != NULL) add_value(g, a, value);
+    }
+
+    free(line);
+    fclose(file);
+
+    snprintf(quantum, sizeof(quantum), "%d", DEFAULT_QUANTUM);
+
+    for (a = 0; a < N_AXES; a++) {
+        if (g->n[a] > 0) continue;
+
+        if (a == QUANTA) add_value(g, a, quantum);
+        else if (defaults[a] != NULL) add_value(g, a, defaults[a]);
+        else {
+            fprintf(stderr, "No %s given in grid %s\n", axes[a], filename);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // A worker cannot report a bad value, so every value is checked here
+    for (int i = 0; i < g->n[TRACES]; i++) {
+        if ((file = fopen(g->values[TRACES][i], "r")) == NULL) {
+            fprintf(stderr, "Cannot open trace %s\n", g->values[TRACES][i]);
+            exit(EXIT_FAILURE);
+        }
+        fclose(file);
+    }
+    for (int i = 0; i < g->n[SCHEDULERS]; i++) {
+        if (get_scheduler(g->values[SCHEDULERS][i]) == UNDEF) {
+            fprintf(stderr, "Unknown scheduler %s\n", g->values[SCHEDULERS][i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < g->n[ALLOCATORS]; i++) {
+        if (get_allocator(g->values[ALLOCATORS][i], &policy) == UNDEF) {
+            fprintf(stderr, "Unknown allocator %s\n", g->values[ALLOCATORS][i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // A run with too little memory for its largest process would never finish
+    for (int t = 0; t < g->n[TRACES]; t++) {
+
+        n = get_procs_from_file(g->values[TRACES][t], &p);
+
+        largest = 0;
+        for (int i = 0; i < n; i++) largest = max(p[i].mem, largest);
+
+        for (int i = 0; i < g->n[ALLOCATORS]; i++) {
+            a = get_allocator(g->values[ALLOCATORS][i], &policy);
+
+            for (int k = 0; k < g->n[MEMORIES]; k++) {
+                if ((memory = atoi(g->values[MEMORIES][k])) < least_memory(a, largest)) {
+                    fprintf(stderr, "Memory %d is too small for allocator %s on %s, which needs %dKB\n",
+                            memory, g->values[ALLOCATORS][i], g->values[TRACES][t],
+                            least_memory(a, largest));
+                    exit(EXIT_FAILURE);
+                }
+            }
+        }
+
+        dag_free_edges(p, n);
+        burst_free_lists(p, n);
+        free(p);
+        p = NULL;
+    }
+    for (int i = 0; i < g->n[QUANTA]; i++) {
+        if (atoi(g->values[QUANTA][i]) <= 0) {
+            fprintf(stderr, "Quantum %s must be positive\n", g->values[QUANTA][i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    g->cells = 1;
+    for (a = 0; a < N_AXES; a++) g->cells *= g->n[a];
+    g->shards = ceil_div(g->cells, g->shard);
+
+    return g;
+}
+
+/*
+ * Frees a grid.
+ *
+ * Grid *g: Pointer to a grid.
+ */
+void grid_free(Grid *g) {
+
+    for (int a = 0; a < N_AXES; a++) {
+        for (int i = 0; i < g->n[a]; i++) free(g->values[a][i]);
+        free(g->values[a]);
+    }
+
+    free(g);
+}
+
+/*
+ * Finds the value of each axis for a run in a grid.
+ */
+static void cell_values(Grid *g, int cell, char **values) {
+
+    for (int a = N_AXES - 1; a >= 0; a--) {
+        values[a] = g->values[a][cell % g->n[a]];
+        cell /= g->n[a];
+    }
+}
+
+/*
+ * Finds the name of the claim on a shard by this worker, as the shard
+ * followed by the host and process ID of the worker.
+ */
+static void claim_path(char *path, char *dir, int k) {
+
+    char host[256] = "";
+
+    gethostname(host, sizeof(host) - 1);
+    snprintf(path, PATH_MAX, "%s/claimed/%d.%s.%d", dir, k, host, (int)getpid());
+}
+
+/*
+ * Checks if a file exists.
+ */
+static int exists(char *path) {
+
+    return access(path, F_OK) == 0;
+}
+
+/*
+ * Writes a file so that it appears whole or not at all, by renaming
+ * it into place once written.
+ */
+static void write_whole(char *path, char *text) {
+
+    char tmp[PATH_MAX];
+    FILE *file;
+
+    snprintf(tmp, sizeof(tmp), "%s.%d.tmp", path, (int)getpid());
+
+    if ((file = fopen(tmp, "w")) == NULL) exit(EXIT_FAILURE);
+    fputs(text, file);
+    fclose(file);
+
+    if (rename(tmp, path)) exit(EXIT_FAILURE);
+}
+
+/*
+ * Makes the directories of a work queue and records the grid in it,
+ * or checks that the grid is the one already recorded.
+ */
+static void queue_init(char *dir, Grid *g) {
+
+    char path[PATH_MAX], *text = NULL, *found = NULL;
+    size_t len = 0, found_len = 0;
+    FILE *file;
+
+    snprintf(path, sizeof(path), "%s", dir);
+    if (mkdir(path, 0777) && errno != EEXIST) exit(EXIT_FAILURE);
+
+    for (int i = 0; i < 3; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, queues[i]);
+        if (mkdir(path, 0777) && errno != EEXIST) exit(EXIT_FAILURE);
+    }
+
+    // The grid as read, so that differences in spacing do not matter
+    file = open_memstream(&text, &len);
+    for (int a = 0; a < N_AXES; a++) {
+        fprintf(file, "%s", axes[a]);
+        for (int i = 0; i < g->n[a]; i++) fprintf(file, " %s", g->values[a][i]);
+        fprintf(file, "\n");
+    }
+    fprintf(file, "shard %d\n", g->shard);
+    fclose(file);
+
+    snprintf(path, sizeof(path), "%s/grid", dir);
+
+    if ((file = fopen(path, "r")) == NULL) {
+        write_whole(path, text);
+    } else {
+        if (getdelim(&found, &found_len, '\0', file) == -1 || strcmp(found, text)) {
+            fprintf(stderr, "Sweep %s was started with a different grid\n", dir);
+            exit(EXIT_FAILURE);
+        }
+        fclose(file);
+    }
+
+    free(found);
+    free(text);
+}
+
+/*
+ * Queues every shard without results that is neither queued nor
+ * claimed by a live worker, giving back the shards claimed by workers
+ * on this machine that have died.
+ *
+ * Returns int: Number of shards without results.
+ */
+static int queue_shards(char *dir, Grid *g, int *tries, int *queued) {
+
+    char path[PATH_MAX], other[PATH_MAX], host[256] = "", *end, *owner, *pid, *text = NULL;
+    char *claimed = (char*)calloc(g->shards, sizeof(char));
+    int pending = 0;
+    size_t len = 0;
+    struct dirent *e;
+    DIR *d;
+    FILE *file;
+
+    gethostname(host, sizeof(host) - 1);
+    *queued = 0;
+
+    snprintf(path, sizeof(path), "%s/claimed", dir);
+    if ((d = opendir(path)) == NULL) exit(EXIT_FAILURE);
+
+    while ((e = readdir(d)) != NULL) {
+
+        // Claims are named shard.host.pid
+        long k = strtol(e->d_name, &end, 10);
+        if (end == e->d_name || *end != '.' || k < 0 || k >= g->shards) continue;
+
+        owner = end + 1;
+        if ((pid = strrchr(owner, '.')) == NULL) continue;
+
+        snprintf(path, sizeof(path), "%s/claimed/%s", dir, e->d_name);
+        snprintf(other, sizeof(other), "%s/done/%ld", dir, k);
+
+        // Finished, but died before giving up the claim
+        if (exists(other)) {
+            unlink(path);
+            continue;
+        }
+
+        // Alive, or elsewhere and so cannot be checked
+        if ((size_t)(pid - owner) != strlen(host) || strncmp(owner, host, pid - owner) ||
+            kill(atoi(pid + 1), 0) == 0 || errno != ESRCH) {
+            claimed[k] = 1;
+            continue;
+        }
+
+        if (++tries[k] > SWEEP_RETRIES) {
+            fprintf(stderr, "Shard %ld of sweep %s failed %d times\n", k, dir, tries[k]);
+            exit(EXIT_FAILURE);
+        }
+
+        snprintf(other, sizeof(other), "%s/todo/%ld", dir, k);
+        if (rename(path, other)) claimed[k] = 1;
+    }
+
+    closedir(d);
+
+    for (int k = 0; k < g->shards; k++) {
+
+        snprintf(path, sizeof(path), "%s/done/%d", dir, k);
+        if (exists(path)) continue;
+
+        pending++;
+        if (claimed[k]) continue;
+
+        (*queued)++;
+        snprintf(path, sizeof(path), "%s/todo/%d", dir, k);
+        if (exists(path)) continue;
+
+        // Each line of a shard is a run, as its cell then the value of each axis
+        file = open_memstream(&text, &len);
+        for (int cell = k * g->shard; cell < min((k + 1) * g->shard, g->cells); cell++) {
+
+            char *values[N_AXES];
+            cell_values(g, cell, values);
+
+            fprintf(file, "%d", cell);
+            for (int a = 0; a < N_AXES; a++) fprintf(file, " %s", values[a]);
+            fprintf(file, "\n");
+        }
+        fclose(file);
+
+        write_whole(path, text);
+    }
+
+    free(text);
+    free(claimed);
+
+    return pending;
+}
+
+/*
+ * Claims a queued shard by moving it to the claimed directory, which
+ * only one worker can do.
+ *
+ * Returns int: Shard claimed, or UNDEF if none are queued.
+ */
+static int claim(char *dir) {
+
+    char from[PATH_MAX], to[PATH_MAX], *end;
+    int k = UNDEF;
+    struct dirent *e;
+    DIR *d;
+
+    snprintf(from, sizeof(from), "%s/todo", dir);
+    if ((d = opendir(from)) == NULL) return UNDEF;
+
+    while (k == UNDEF && (e = readdir(d)) != NULL) {
+
+        // Files being written have a suffix
+        long s = strtol(e->d_name, &end, 10);
+        if (end == e->d_name || *end != '\0') continue;
+
+        snprintf(from, sizeof(from), "%s/todo/%s", dir, e->d_name);
+        claim_path(to, dir, (int)s);
+
+        if (rename(from, to) == 0) k = (int)s;
+    }
+
+    closedir(d);
+
+    return k;
+}
+
+/*
+ * Runs one run of a sweep and prints its statistics, after the cell
+ * they belong to.
+ */
+static void run_cell(FILE *out, int cell, char **values) {
+
+    int policy, n;
+    Process *p = NULL;
+    System *sys;
+
+    n = get_procs_from_file(values[TRACES], &p);
+    sys = create_system(p, n, get_scheduler(values[SCHEDULERS]),
+                        get_allocator(values[ALLOCATORS], &policy),
+                        atoi(values[MEMORIES]), atoi(values[QUANTA]));
+    if (policy != UNDEF) sys->policy = policy;
+
+    // Only the statistics are kept
+    sys->out = NULL;
+    run(sys);
+
+    sys->out = out;
+    fprintf(out, "cell %d\n", cell);
+    print_stats(sys);
+    fprintf(out, "\n");
+
+    store_free(sys);
+    frag_free(sys);
+    stats_free(sys);
+
+    dag_free_edges(p, n);
+    burst_free_lists(p, n);
+    free(sys->table.states);
+    free(p);
+    free(sys);
+}
+
+/*
+ * Runs every run of a claimed shard, then moves its results into
+ * place before giving up the claim.
+ */
+static void run_shard(char *dir, int k) {
+
+    char claimed[PATH_MAX], done[PATH_MAX], tmp[PATH_MAX], *line = NULL, *values[N_AXES];
+    size_t len = 0;
+    FILE *shard, *out;
+    int cell, a;
+
+    claim_path(claimed, dir, k);
+    snprintf(done, sizeof(done), "%s/done/%d", dir, k);
+    snprintf(tmp, sizeof(tmp), "%s/done/%d.%d.tmp", dir, k, (int)getpid());
+
+    if ((shard = fopen(claimed, "r")) == NULL) exit(EXIT_FAILURE);
+    if ((out = fopen(tmp, "w")) == NULL) exit(EXIT_FAILURE);
+
+    while (getline(&line, &len, shard) != -1) {
+
+        cell = atoi(strtok(line, " \n"));
+        for (a = 0; a < N_AXES && (values[a] = strtok(NULL, " \n")) != NULL; a++);
+
+        if (a == N_AXES) run_cell(out, cell, values);
+    }
+
+    free(line);
+    fclose(shard);
+    fclose(out);
+
+    if (rename(tmp, done)) exit(EXIT_FAILURE);
+    unlink(claimed);
+}
+
+/*
+ * Claims and runs shards from a work queue until it is empty.
+ *
+ * char *dir: Directory of the work queue.
+ */
+void sweep_work(char *dir) {
+
+    int k;
+
+    while ((k = claim(dir)) != UNDEF) run_shard(dir, k);
+}
+
+/*
+ * Prints the statistics of every run of a finished sweep as one table,
+ * in the order of the grid.
+ */
+static void print_table(char *dir, Grid *g) {
+
+    char (*stats)[N_RESULTS][SWEEP_VALUE] = calloc(g->cells, sizeof(*stats));
+    char path[PATH_MAX], *line = NULL, *row[N_AXES + N_RESULTS];
+    int width[N_AXES + N_RESULTS], cell = UNDEF, c;
+    size_t len = 0;
+    FILE *file;
+
+    for (int k = 0; k < g->shards; k++) {
+
+        snprintf(path, sizeof(path), "%s/done/%d", dir, k);
+        if ((file = fopen(path, "r")) == NULL) exit(EXIT_FAILURE);
+
+        while (getline(&line, &len, file) != -1) {
+
+            line[strcspn(line, "\n")] = '\0';
+
+            if (sscanf(line, "cell %d", &cell) == 1) continue;
+            if (cell < 0 || cell >= g->cells) continue;
+
+            for (int r = 0; r < N_RESULTS; r++) {
+                if (!strncmp(line, results[r], strlen(results[r]))) {
+                    snprintf(stats[cell][r], SWEEP_VALUE, "%s", line + strlen(results[r]));
+                }
+            }
+        }
+
+        fclose(file);
+    }
+
+    free(line);
+
+    // Columns are as wide as their widest value
+    for (c = 0; c < N_AXES + N_RESULTS; c++) width[c] = strlen(columns[c]);
+
+    for (cell = 0; cell < g->cells; cell++) {
+        cell_values(g, cell, row);
+        for (c = 0; c < N_AXES + N_RESULTS; c++) {
+            if (c >= N_AXES) row[c] = stats[cell][c - N_AXES];
+            width[c] = max(width[c], (int)strlen(row[c]));
+        }
+    }
+
+    for (c = 0; c < N_AXES + N_RESULTS; c++) {
+        printf(c < N_AXES + N_RESULTS - 1 ? "%-*s  " : "%-*s\n", width[c], columns[c]);
+    }
+
+    for (cell = 0; cell < g->cells; cell++) {
+        cell_values(g, cell, row);
+        for (c = 0; c < N_AXES + N_RESULTS; c++) {
+            if (c >= N_AXES) row[c] = stats[cell][c - N_AXES];
+            if (c < N_AXES + N_RESULTS - 1) printf("%-*s  ", width[c], row[c]);
+            else printf("%s\n", row[c]);
+        }
+    }
+
+    free(stats);
+}
+
+/*
+ * Runs a sweep over a grid, queueing every shard without results and
+ * running workers until every shard has results, then prints the
+ * statistics of every run as one table. Shards claimed by workers that
+ * died on this machine are queued again, and shards claimed by workers
+ * elsewhere are waited for.
+ *
+ * char *dir:   Directory of the work queue, made if it does not exist.
+ * Grid *g:     Pointer to the grid, which must be the same if resuming.
+ * int workers: Number of workers to run, or 0 for one per processor.
+ */
+void sweep(char *dir, Grid *g, int workers) {
+
+    int *tries = (int*)calloc(g->shards, sizeof(int)), queued, n;
+    pid_t *pids;
+
+    if (workers <= 0) workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    workers = max(workers, 1);
+    pids = (pid_t*)malloc(workers * sizeof(pid_t));
+
+    queue_init(dir, g);
+
+    while (queue_shards(dir, g, tries, &queued) > 0) {
+
+        // Only shards claimed elsewhere are left
+        if (queued == 0) {
+            sleep(SWEEP_POLL);
+            continue;
+        }
+
+        // Children must not write out what the parent has buffered
+        fflush(NULL);
+
+        n = min(workers, queued);
+        for (int i = 0; i < n; i++) {
+            if ((pids[i] = fork()) == 0) {
+                sweep_work(dir);
+                _exit(EXIT_SUCCESS);
+            }
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (pids[i] > 0) waitpid(pids[i], NULL, 0);
+        }
+
+        // Without any children the queue is still worked through
+        if (pids[0] < 0) sweep_work(dir);
+    }
+
+    print_table(dir, g);
+
+    free(pids);
+    free(tries);
+}
@@ -40,35 +40,44 @@ int compare_int(const void *a, const void *b) {
 }
 
 /*
- * Creates and allocated memory for a new process with 
- * initialised values.
+ * Initialises a process in place, such as in the process table.
+ * Its page table is only made if it is demand paged.
  * 
- * int id:
- * int mem:
- * int t_arrived: The time that the process arrived.
- * int t_job:     Total CPU time required to run the process.
- * 
- * Returns Process*: Pointer to the new Process struct.
+ * Process *p:    Pointer to the process.
+ * int id:        Process ID.
+ * int mem:       Memory required (in KB).
+ * Time t_arrived: The time that the process arrived.
+ * Time t_job:     Total CPU time required to run the process.
  */
-Process *create_process(int id, int mem, int t_arrived, int t_job) {
+void init_process(Process *p, int id, int mem, Time t_arrived, Time t_job) {
 
-    Process *p = (Process*)calloc(1, sizeof(Process));
+    memset(p, 0, sizeof(Process));
     
-    p->status = INIT;
     p->id = id;
 
     p->mem = mem;
     p->n_pages = 0;
-    p->pages = (Page**)calloc(1, (mem / PAGE_SIZE) * sizeof(void*));
+    p->pages = NULL;
 
     p->time.arrived = t_arrived;
     p->time.job = p->time.remaining = t_job;
-    p->time.last = p->time.started = p->time.finished = UNDEF;
-    p->time.load = 0;
+    p->time.last = p->time.started = p->time.finished = p->time.admitted = UNDEF;
+    p->time.load = p->time.fault = 0;
 
-    return p;
+    p->weight = CFS_WEIGHT;
+    p->vruntime = 0;
+    p->io = UNDEF;
+    p->burst = p->wake = UNDEF;
 }
 
+/*
+ * Creates a process table, sorting its processes in place.
+ * 
+ * Process *p: Pointer to array of Processes for the process table.
+ * int n:      Number of processes.
+ * 
+ * Returns PTable*: Pointer to the new process table.
+ */
 PTable *create_table(Process *p, int n) {
 
     // Sort processes in increasing order of arrival time and ID
@@ -79,8 +88,13 @@ PTable *create_table(Process *p, int n) {
     table->status = INIT;
     table->context = UNDEF;
     table->p = p;
+
+    table->states = (Status*)malloc(max(n, 1) * sizeof(Status));
+    for (int i = 0; i < n; i++) table->states[i] = INIT;
+
     table->n = n;
     table->n_alive = 0;
+    table->next = 0;
 
     return table;
 }
@@ -88,108 +102,395 @@ PTable *create_table(Process *p, int n) {
 /*
  * Receives a newly arrived process.
  * 
- * Process *p: Pointer to process.
+ * PTable *t: Pointer to a process table.
+ * int i:     Index in the process table of the process.
+ */
+void activate(PTable *t, int i) {
+
+    t->states[i] = START;
+    t->p[i].time.last = t->p[i].time.arrived;
+}
+
+/*
+ * Hands a newly arrived process to the scheduling algorithm
+ * if it keeps its own record of the processes ready to run.
+ * 
+ * System *sys: Pointer to the OS.
+ * int i:       Index in the process table of the new process.
+ */
+void admit(System *sys, int i) {
+
+    switch (sys->scheduler) {
+        case MLFQ: mlfq_admit(sys, i); break;
+        case CS:
+        case SRTF:
+        case CP: heap_push(sys->ready, i); break;
+        case CFS: cfs_admit(sys, i); break;
+        case MA: ma_admit(sys, i); break;
+        case RR: if (sys->batch) enqueue(sys->fifo, i); break;
+        default: break;
+    }
+}
+
+/*
+ * Lets the scheduling algorithm know that the number of pages
+ * a process has in memory has changed.
+ * 
+ * System *sys: Pointer to the OS.
+ * int i:       Index in the process table of the process.
  */
-void activate(Process *p) {
+void residency_changed(System *sys, int i) {
 
-    p->status = START;
-    p->time.last = p->time.arrived;
+    switch (sys->scheduler) {
+        case MA: heap_update(sys->ready, i); break;
+        default: break;
+    }
 }
 
 /*
- * Checks for newly arrived processes.
+ * Hands a process back to the scheduling algorithm after it
+ * waited for its pages to load.
+ * 
+ * System *sys: Pointer to the OS.
+ * int i:       Index in the process table of the process.
+ */
+void requeue(System *sys, int i) {
+
+    switch (sys->scheduler) {
+        case MLFQ: enqueue(sys->queues[sys->table.p[i].level], i); break;
+        case CS:
+        case SRTF:
+        case CP: heap_push(sys->ready, i); break;
+        case CFS: pheap_push(sys->tree, i); break;
+        case MA: ma_admit(sys, i); break;
+        case RR: if (sys->batch) enqueue(sys->fifo, i); break;
+        default: break;
+    }
+}
+
+/*
+ * Finds the process the scheduling algorithm will most likely
+ * run next, without changing the current context.
+ * 
+ * System *sys: Pointer to the OS.
+ * 
+ * Returns int: Index in the process table of the process, or UNDEF
+ *              if unknown.
+ */
+int upcoming(System *sys) {
+
+    switch (sys->scheduler) {
+
+        case FF:
+            for (int i = 0; i < sys->table.n; i++) {
+                if (sys->table.states[i] == START || sys->table.states[i] == READY) return i;
+            }
+            break;
+
+        case RR:
+            if (sys->batch && sys->fifo->n) return sys->fifo->items[sys->fifo->head];
+            break;
+
+        case CS:
+        case SRTF:
+        case CP:
+        case MA:
+            if (sys->ready->n) return sys->ready->items[0];
+            break;
+
+        case MLFQ:
+            for (int i = 0; i < sys->levels; i++) {
+                if (sys->queues[i]->n) return sys->queues[i]->items[sys->queues[i]->head];
+            }
+            break;
+
+        case CFS: if (sys->tree->n) return sys->tree->root; break;
+
+        default: break;
+    }
+
+    return UNDEF;
+}
+
+/*
+ * Checks if there is memory to admit a process, which there always
+ * is when no other process has been admitted.
+ */
+static int admissible(System *sys, int i) {
+
+    return !sys->committed || sys->committed + sys->table.p[i].mem <= sys->admission * sys->mem_size;
+}
+
+/*
+ * Receives a process once it has been admitted.
+ */
+static void receive(System *sys, int i, Time admitted) {
+
+    // Shorthand
+    PTable *t = &sys->table;
+
+    activate(t, i);
+    t->p[i].time.last = t->p[i].time.admitted = admitted;
+    admit(sys, i);
+
+    t->n_alive++;
+    sys->committed += t->p[i].mem;
+    sys->status = sys->status == TERMINATED ? READY : sys->status;
+}
+
+/*
+ * Receives a process that has arrived, or has it wait to be admitted
+ * behind any processes already waiting or until there is memory.
+ * 
+ * System *sys:  Pointer to the OS.
+ * int i:        Index in the process table of the process.
+ * Time arrived: Time it arrived, or was released by its parents.
+ */
+void arrive(System *sys, int i, Time arrived) {
+
+    // Wait behind any processes already waiting, or until there is memory
+    if (sys->pending != NULL && (sys->pending->n || !admissible(sys, i))) {
+        heap_push(sys->pending, i);
+    } else {
+        receive(sys, i, arrived);
+    }
+}
+
+/*
+ * Checks for newly arrived processes, and admits those waiting
+ * for memory once there is enough.
  * 
  * System *sys: Pointer to the OS.
  */
 void get_processes(System *sys) {
 
     // Shorthand
-    Process *p = sys->table.p;
+    PTable *t = &sys->table;
 
-    for (int i = 0; i < sys->table.n; i++) {
-        if (p[i].status == INIT && p[i].time.arrived <= sys->time) {
+    // Arrivals up to now must be known before any are received
+    online_until(sys, sys->time);
 
-            activate(&p[i]);
+    // Samples since the clock last moved on, such as during a page load,
+    // show the OS before anything that has arrived since is received
+    series_sample(sys);
 
-            sys->table.n_alive++;
-            sys->status = sys->status == TERMINATED ? READY : sys->status;
-        }
+    PROFILE_START(sys, ADMISSION);
+
+    // Processes whose pages have finished loading are ready again
+    if (sys->store != NULL) store_poll(sys);
+
+    // As are those whose I/O has completed
+    burst_wake(sys);
+
+    // Table is in order of arrival so only the next processes need checking
+    while (t->next < t->n && t->p[t->next].time.arrived <= sys->time) {
+
+        // Processes still waiting for their parents arrive once those finish
+        if (!dag_blocked(sys, t->next)) arrive(sys, t->next, t->p[t->next].time.arrived);
+
+        t->next++;
     }
+
+    // Waiting processes are admitted in scheduling order as memory frees up
+    while (sys->pending != NULL && sys->pending->n && admissible(sys, sys->pending->items[0])) {
+        receive(sys, heap_pop(sys->pending), sys->time);
+    }
+
+    PROFILE_STOP(sys, ADMISSION);
 }
 
 /*
- * Begins running the process in the current context and evitcts
- * memory to allow it to run.
+ * Finds when the next process that has not yet been received
+ * will arrive.
+ * 
+ * System sys: OS data structure.
+ * 
+ * Returns Time: Arrival time of the next process, or UNDEF if
+ *              all processes have been received.
+ */
+Time next_arrival(System sys) {
+
+    if (sys.table.next == sys.table.n) return UNDEF;
+
+    return sys.table.p[sys.table.next].time.arrived;
+}
+
+/*
+ * Finds when the next process will arrive or finish loading.
+ * 
+ * System *sys: Pointer to the OS.
+ * 
+ * Returns Time: Time of the next event, or UNDEF if none.
+ */
+static Time next_event(System *sys) {
+
+    // Wait for the next process to be sent if none are known
+    if (sys->table.next == sys->table.n) online_next(sys);
+
+    Time arrival = next_arrival(*sys), loaded = store_next(sys), wake = burst_next(sys);
+
+    if (loaded == UNDEF || (wake != UNDEF && wake < loaded)) loaded = wake;
+
+    if (arrival == UNDEF) return loaded;
+    if (loaded == UNDEF) return arrival;
+
+    return min(arrival, loaded);
+}
+
+/*
+ * Dispatches the process in the current context, evicting memory
+ * to allow it to run.
  * 
  * System *sys: Pointer to an OS.
+ * 
+ * Returns Status: LOADING if the process is waiting for its pages
+ *                 to load in the background, RUNNING otherwise.
  */
-void process_start(System *sys) {
+static Status dispatch(System *sys) {
+
+    int stalled = 0;
 
     // Shorthand
     Process *p = &sys->table.p[sys->table.context];
 
+    if (sys->store != NULL) {
+
+        // Already being prefetched so wait for it to finish
+        if (p->io > sys->time) {
+            sys->table.states[sys->table.context] = LOADING;
+            sys->store->waiting++;
+            return LOADING;
+        }
+
+        stalled = store_reserve(sys);
+    }
+
+    PROFILE_START(sys, ALLOCATION);
+
     // Handle memory
     switch (sys->allocator) {
 
         case SWP: swap(sys); break;
         case V: virtual(sys); break;
         case CM: smallswap(sys); break;
+        case D: demand(sys); break;
         default: break;
     }
 
+    PROFILE_STOP(sys, ALLOCATION);
+
+    // Let another process run while the pages load
+    if (store_load(sys, stalled) == LOADING) {
+        flush_evictions(sys);
+        return LOADING;
+    }
+
+    // Increase remaining time for page faults, once the process runs so a
+    // process dispatched again after its pages load isn't charged twice
+    p->time.remaining += fault_penalty(sys);
+
+    // Make the process contiguous if it is not
+    compact(sys);
+    frag_sample(sys);
+
     p->time.started = p->time.last = sys->time;
-    p->status = RUNNING;
+    sys->table.states[sys->table.context] = RUNNING;
+    p->io = UNDEF;
 
+    flush_evictions(sys);
     notify(RUN, *sys, 0);
 
+    store_prefetch(sys);
+
     sys->time += p->time.load;
+
+    return RUNNING;
 }
 
 /*
- * Pauses the currently running process.
+ * Begins running the process in the current context and evitcts
+ * memory to allow it to run.
  * 
- * System *sys: Pointer to an OS struct.
+ * System *sys: Pointer to an OS.
+ * 
+ * Returns Status: LOADING if the process is waiting for its pages
+ *                 to load in the background, RUNNING otherwise.
  */
-void process_pause(System *sys) {
+Status process_start(System *sys) {
+
+    return dispatch(sys);
+}
+
+/*
+ * Runs the process in the current context, advancing the clock
+ * by the time given plus any time it is stalled by page faults.
+ * 
+ * System *sys:  Pointer to an OS struct.
+ * Time runtime: CPU time to run the process for.
+ */
+void process_run(System *sys, Time runtime) {
+
+    Time start = sys->time;
 
     // Shorthand
     Process *p = &sys->table.p[sys->table.context];
 
-    // Reduce time remaining by time spent processing
-    p->time.remaining -= sys->time - p->time.last - p->time.load;
-    p->time.last = sys->time;
+    // Counts down to the end of its CPU burst
+    if (p->burst != UNDEF) p->burst -= runtime;
 
-    p->status = READY;
+    if (sys->allocator == D) {
+        demand_run(sys, runtime);
+    } else {
+        sys->time += runtime;
+    }
 
-    // Check if any new processes have arrived
-    get_processes(sys);
+    series_run(sys, start);
 }
 
 /*
- * Resumes a paused process.
+ * Pauses the currently running process, blocking it instead if
+ * it has reached the end of a CPU burst.
  * 
  * System *sys: Pointer to an OS struct.
+ * 
+ * Returns Status: BLOCKED if it is waiting for I/O, READY otherwise.
  */
-void process_resume(System *sys) {
+Status process_pause(System *sys) {
+
+    Status status;
 
     // Shorthand
     Process *p = &sys->table.p[sys->table.context];
 
-    // Handle memory
-    switch (sys->allocator) {
+    // Reduce time remaining by time spent processing
+    p->time.remaining -= sys->time - p->time.last - p->time.load;
+    p->time.last = sys->time;
 
-        case SWP: swap(sys); break;
-        case V: virtual(sys); break;
-        case CM: smallswap(sys); break;
-        default: break;
-    }
+    sys->table.states[sys->table.context] = READY;
 
-    p->time.started = p->time.last = sys->time;
-    p->status = RUNNING;
+    // Wait for I/O, which always takes some time so can't complete yet
+    if (!p->burst) burst_block(sys);
+    status = sys->table.states[sys->table.context];
 
-    notify(RUN, *sys, 0);
+    // Check if any new processes have arrived
+    get_processes(sys);
 
-    sys->time += p->time.load;
+    if (status == BLOCKED) notify(BLOCK, *sys, 0);
+
+    return status;
+}
+
+/*
+ * Resumes a paused process.
+ * 
+ * System *sys: Pointer to an OS struct.
+ * 
+ * Returns Status: LOADING if the process is waiting for its pages
+ *                 to load in the background, RUNNING otherwise.
+ */
+Status process_resume(System *sys) {
+
+    return dispatch(sys);
 }
 
 /*
@@ -203,11 +504,17 @@ void process_finish(System *sys) {
 
     p->time.remaining = 0;
     p->time.finished = p->time.last = sys->time;
-    p->status = TERMINATED;
+    sys->table.states[sys->table.context] = TERMINATED;
 
     sys->table.n_alive--;
+    sys->committed -= p->mem;
+
+    stats_finish(sys, p);
+
+    if (sys->allocator != U) evict_process(sys, sys->table.context, p->n_pages);
 
-    if (sys->allocator != U) evict_process(sys, p->id, p->n_pages);
+    // Children waiting only for this process arrive now
+    dag_finish(sys, sys->table.context);
 
     // Check if any new processes have arrived
     get_processes(sys);
@@ -225,17 +532,15 @@ void process_finish(System *sys) {
  */
 int keep_alive(System sys) {
 
-    // Check status flags of processes
-    for (int i = 0; i < sys.table.n; i++) {
-        if (sys.table.p[i].status != TERMINATED) return 1;
-    }
-
-    return 0;
+    // Processes yet to arrive, waiting to be admitted, or that have arrived but not been terminated
+    return sys.table.next < sys.table.n || sys.table.n_alive || (sys.pending != NULL && sys.pending->n) ||
+           (sys.online != NULL && !sys.online->eof);
 }
 
 /*
- * Begins running and handles all dispatch to continue running
- * the OS.
+ * Creates an OS ready to run with default values for any
+ * algorithm specific settings, which may be changed before
+ * it is run.
  * 
  * Process *p:  Pointer to array of Processes for the process table.
  * int n:       Number of processes.
@@ -244,9 +549,9 @@ int keep_alive(System sys) {
  * int m:       System memory size.
  * int q:       Quantam time for scheduling.
  * 
- * Returns System*: Pointer to the OS struct in its final state.
+ * Returns System*: Pointer to the new OS struct.
  */
-System *start(Process *p, int n, Scheduler s, Allocator a, int m, int q) {
+System *create_system(Process *p, int n, Scheduler s, Allocator a, int m, int q) {
 
     System *sys = (System*)calloc(1, sizeof(System));
 
@@ -255,9 +560,6 @@ System *start(Process *p, int n, Scheduler s, Allocator a, int m, int q) {
     memmove(&sys->table, table, sizeof(PTable));
     free(table);
 
-    // Setup memory
-    sys->pages = create_memory(m, PAGE_SIZE);
-
     // Setup system variables
     sys->scheduler = s;
     sys->allocator = a;
@@ -267,8 +569,94 @@ System *start(Process *p, int n, Scheduler s, Allocator a, int m, int q) {
     sys->n_pages = m / PAGE_SIZE;
     sys->time = 0;
 
+    // Algorithm specific settings
+    sys->levels = MLFQ_LEVELS;
+    sys->boost = MLFQ_BOOST;
+    sys->granularity = CFS_GRANULARITY;
+    sys->aging = MA_AGING;
+    sys->access = UNIFORM;
+    sys->seed = DEFAULT_SEED;
+    sys->policy = LRU;
+    sys->compaction = UNDEF;
+    sys->checkpoint = UNDEF;
+    sys->out = stdout;
+
+    sys->status = INIT;
+
+    return sys;
+}
+
+/*
+ * Handles all dispatch to run the OS until every process
+ * has been terminated.
+ * 
+ * System *sys: Pointer to an OS struct.
+ */
+void run(System *sys) {
+
+    // Setup memory, unless restored from a checkpoint
+    if (sys->pages == NULL) sys->pages = create_memory(sys->mem_size, sys->page_size);
+    frames_init(sys);
+
+    // Setup statistics
+    stats_init(sys);
+
+    // Setup dependencies, which hold back processes whose parents are still to finish
+    dag_init(sys);
+
+    // Setup the queue of processes blocked for I/O
+    burst_init(sys);
+
+    // Setup admission control, where processes still waiting when checkpointed wait again
+    if (sys->admission > 0 && sys->mem_size > 0) {
+        sys->pending = create_heap((void**)&sys->table.p, sys->table.n, sizeof(Process),
+                                   sys->scheduler == CS ? compare_job :
+                                   sys->scheduler == SRTF ? compare_remaining :
+                                   sys->scheduler == CP ? compare_critical : compare);
+
+        for (int i = 0; i < sys->table.next; i++) {
+            if (sys->table.states[i] == INIT && !dag_blocked(sys, i)) heap_push(sys->pending, i);
+        }
+    }
+
+    // Setup page tables and replacement
+    if (sys->allocator == D) {
+        demand_init(sys);
+        replace_init(sys);
+    }
+
+    // Setup fragmentation tracking
+    if (sys->fragmentation || sys->compaction != UNDEF) frag_init(sys);
+
+    // Setup backing store, demand paging faults are still synchronous
+    if (sys->bandwidth > 0 && sys->allocator != U && sys->allocator != D) store_init(sys);
+
+    // Setup scheduler
+    switch (sys->scheduler) {
+        case CS:
+            sys->ready = create_heap((void**)&sys->table.p, sys->table.n,
+                                     sizeof(Process), compare_job);
+            break;
+        case MLFQ: mlfq_init(sys); break;
+        case SRTF:
+            sys->ready = create_heap((void**)&sys->table.p, sys->table.n,
+                                     sizeof(Process), compare_remaining);
+            break;
+        case CFS: cfs_init(sys); break;
+        case MA: ma_init(sys); break;
+        case CP:
+            sys->ready = create_heap((void**)&sys->table.p, sys->table.n,
+                                     sizeof(Process), compare_critical);
+            break;
+        case RR: if (sys->batch) sys->fifo = create_queue(sys->table.n); break;
+        default: break;
+    }
+
+    // Continue from a checkpoint
+    restore_state(sys);
+
     // We are go for launch
-    sys->status = READY;
+    if (sys->status == INIT) sys->status = READY;
 
     // Cycle clock until all processes have been terminated
     while (sys->status != TERMINATED || keep_alive(*sys)) {
@@ -276,17 +664,73 @@ System *start(Process *p, int n, Scheduler s, Allocator a, int m, int q) {
         // Check if any processes are ready
         get_processes(sys);
 
-        if (sys->status == TERMINATED) sys->time++;
+        // Idle until the next process arrives or finishes loading
+        if (sys->status == TERMINATED) {
+            sys->time = next_event(sys) == UNDEF ?
+                        sys->time + 1 :
+                        max(sys->time + 1, next_event(sys));
+
+            series_sample(sys);
+        }
 
         switch (sys->scheduler) {
             case FF: ff_step(sys); break;
             case RR: rr_step(sys); break;
             case CS: cs_step(sys); break;
+            case MLFQ: mlfq_step(sys); break;
+            case SRTF: srtf_step(sys); break;
+            case CFS: cfs_step(sys); break;
+            case MA: ma_step(sys); break;
+            case CP: cs_step(sys); break;
             default: break;
         }
+
+        flush_evictions(sys);
+
+        // Save the state between cycles once the time is reached
+        if (sys->checkpoint != UNDEF && sys->time >= sys->checkpoint) {
+            checkpoint(sys, sys->checkpoint_file);
+            sys->checkpoint = UNDEF;
+        }
     }
 
+    free_heap(sys->ready);
+    sys->ready = NULL;
+    free_heap(sys->pending);
+    sys->pending = NULL;
+    dag_free(sys);
+    burst_free(sys);
+    mlfq_free(sys);
+    cfs_free(sys);
+    ma_free(sys);
+    free_queue(sys->fifo);
+    sys->fifo = NULL;
+    free(sys->evicted);
+    sys->evicted = NULL;
+    replace_free(sys);
+    demand_free(sys);
+    frames_free(sys);
     free(sys->pages);
+}
+
+/*
+ * Begins running and handles all dispatch to continue running
+ * the OS.
+ * 
+ * Process *p:  Pointer to array of Processes for the process table.
+ * int n:       Number of processes.
+ * Scheduler s: Enumerated value for which scheduling algorithm to use.
+ * Allocator a: Enumerated value for which memory allocation algorithm to use.
+ * int m:       System memory size.
+ * int q:       Quantam time for scheduling.
+ * 
+ * Returns System*: Pointer to the OS struct in its final state.
+ */
+System *start(Process *p, int n, Scheduler s, Allocator a, int m, int q) {
+
+    System *sys = create_system(p, n, s, a, m, q);
+
+    run(sys);
 
     return sys;
 }
@@ -0,0 +1,282 @@
+/*
+ * tracegen
+ *
+ * Generates synthetic process files for the scheduling simulator,
+ * with a choice of arrival process and of job time and memory
+ * distributions. Written for project 2 of COMP30023 Computer
+ * Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "sys.h"
+
+#define OPTARGS "n:a:r:j:J:m:M:X:P:S:D:I:C:"
+
+// Mean number of processes arriving together in a burst
+#define BURST_SIZE 10
+
+// Diurnal arrival rate varies by this fraction either side of the mean
+#define DIURNAL_AMPLITUDE 0.9
+#define DIURNAL_PERIOD    1000
+
+// Shape of the heavy tailed Pareto distribution
+#define PARETO_ALPHA 1.5
+
+// Parents are chosen from this many processes before each one
+#define DAG_WINDOW 20
+
+// Mean CPU burst between I/O bursts when none is given
+#define CPU_BURST 5
+
+#define PI 3.14159265358979323846
+
+typedef enum arrivals { POISSON, BURSTY, DIURNAL } Arrivals;
+typedef enum distribution { UNIFORM_DIST, EXPONENTIAL, PARETO } Distribution;
+
+/*
+ * Random number streams and settings for generating a trace.
+ *
+ * Arrivals arrivals:      Process by which processes arrive.
+ * double rate:            Mean number of arrivals each second.
+ * int period:             Length of a day for diurnal arrivals.
+ * Distribution job:       Distribution of job times.
+ * double job_mean:        Mean job time.
+ * Distribution mem:       Distribution of memory sizes.
+ * double mem_mean:        Mean memory size in KB.
+ * int mem_max:            Largest memory size in KB.
+ * double time:            Time of the most recent arrival.
+ * int burst:              Arrivals left in the current burst.
+ * int parents:            Most processes each process depends on.
+ * double io_mean:         Mean I/O burst, or 0 for processes without I/O.
+ * double cpu_mean:        Mean CPU burst between I/O bursts.
+ * uint64_t arrival_rng:   Stream for arrival times.
+ * uint64_t job_rng:       Stream for job times.
+ * uint64_t mem_rng:       Stream for memory sizes.
+ * uint64_t dag_rng:       Stream for dependencies.
+ * uint64_t burst_rng:     Stream for CPU and I/O bursts.
+ */
+typedef struct Trace {
+    Arrivals arrivals;
+    double rate;
+    int period;
+    Distribution job;
+    double job_mean;
+    Distribution mem;
+    double mem_mean;
+    int mem_max;
+    double time;
+    int burst;
+    int parents;
+    double io_mean, cpu_mean;
+    uint64_t arrival_rng, job_rng, mem_rng, dag_rng, burst_rng;
+} Trace;
+
+/*
+ * Reads the name of a distribution.
+ *
+ * char *name: u (uniform), e (exponential) or p (Pareto).
+ *
+ * Returns Distribution: Enumerated distribution.
+ */
+Distribution get_distribution(char *name) {
+
+    if (!strcmp(name, "e")) return EXPONENTIAL;
+    if (!strcmp(name, "p")) return PARETO;
+    return UNIFORM_DIST;
+}
+
+/*
+ * Draws an exponentially distributed value.
+ *
+ * uint64_t *rng: Pointer to the state of a random number stream.
+ * double mean:   Mean of the distribution.
+ *
+ * Returns double: Value drawn.
+ */
+double exponential(uint64_t *rng, double mean) {
+
+    return -mean * log(1 - rng_uniform(rng));
+}
+
+/*
+ * Draws a value of at least 1 from a distribution.
+ *
+ * Distribution d: Distribution to draw from.
+ * uint64_t *rng:  Pointer to the state of a random number stream.
+ * double mean:    Mean of the distribution.
+ *
+ * Returns int: Value drawn.
+ */
+int draw(Distribution d, uint64_t *rng, double mean) {
+
+    double x, xm = mean * (PARETO_ALPHA - 1) / PARETO_ALPHA;
+
+    switch (d) {
+
+        case EXPONENTIAL:
+            x = exponential(rng, mean);
+            break;
+
+        case PARETO:
+            x = xm / pow(1 - rng_uniform(rng), 1 / PARETO_ALPHA);
+            break;
+
+        default:
+            x = rng_uniform(rng) * 2 * mean;
+            break;
+    }
+
+    return x < 1 ? 1 : (x > INT_MAX / 2 ? INT_MAX / 2 : (int)x);
+}
+
+/*
+ * Finds the arrival time of the next process.
+ *
+ * Trace *t: Pointer to the trace being generated.
+ *
+ * Returns Time: Arrival time of the next process.
+ */
+Time next_time(Trace *t) {
+
+    double rate_max = t->rate * (1 + DIURNAL_AMPLITUDE), phase;
+
+    switch (t->arrivals) {
+
+        case BURSTY:
+
+            // Bursts arrive less often so the mean rate is unchanged
+            if (t->burst == 0) {
+                t->time += exponential(&t->arrival_rng, BURST_SIZE / t->rate);
+                t->burst = 1 + (int)exponential(&t->arrival_rng, BURST_SIZE - 1);
+            }
+            t->burst--;
+            break;
+
+        case DIURNAL:
+
+            // Thin arrivals at the peak rate down to the rate at the time
+            do {
+                t->time += exponential(&t->arrival_rng, 1 / rate_max);
+                phase = sin(2 * PI * t->time / t->period);
+            } while (rng_uniform(&t->arrival_rng) * (1 + DIURNAL_AMPLITUDE) >
+                     1 + DIURNAL_AMPLITUDE * phase);
+            break;
+
+        default:
+            t->time += exponential(&t->arrival_rng, 1 / t->rate);
+            break;
+    }
+
+    return (Time)t->time;
+}
+
+/*
+ * Prints the processes a process depends on, between none and the
+ * most allowed, chosen from the processes just before it.
+ *
+ * Trace *t: Pointer to the trace being generated.
+ * int id:   ID of the process.
+ */
+void print_parents(Trace *t, int id) {
+
+    int n = (int)(rng_uniform(&t->dag_rng) * (t->parents + 1)), lowest = max(id - DAG_WINDOW, 1);
+
+    n = min(n, id - 1);
+
+    for (int k = 0; k < n; k++) {
+        printf("%s%d", k ? "," : " after=",
+               lowest + (int)(rng_uniform(&t->dag_rng) * (id - lowest)));
+    }
+}
+
+/*
+ * Prints exponentially distributed CPU and I/O bursts of a process,
+ * with its last CPU burst running for what is left of its job.
+ *
+ * Trace *t: Pointer to the trace being generated.
+ * int job:  Job time of the process.
+ */
+void print_bursts(Trace *t, int job) {
+
+    int cpu = draw(EXPONENTIAL, &t->burst_rng, t->cpu_mean), n = 0;
+
+    while (cpu < job) {
+        printf("%s%d,%d", n++ ? "," : " bursts=", cpu, draw(EXPONENTIAL, &t->burst_rng, t->io_mean));
+        job -= cpu;
+        cpu = draw(EXPONENTIAL, &t->burst_rng, t->cpu_mean);
+    }
+
+    if (n) printf(",%d", job);
+}
+
+int main(int argc, char **argv) {
+
+    int opt, n = 1000, mem, job;
+    uint64_t seed = DEFAULT_SEED;
+    Trace t = {
+        .arrivals = POISSON, .rate = 1, .period = DIURNAL_PERIOD,
+        .job = UNIFORM_DIST, .job_mean = 20,
+        .mem = UNIFORM_DIST, .mem_mean = 16, .mem_max = 100,
+        .cpu_mean = CPU_BURST
+    };
+
+    // Handle CL options
+    while ((opt = getopt(argc, argv, OPTARGS)) != -1) {
+        switch (opt) {
+            case 'n': n = atoi(optarg); break;
+
+            case 'a':
+                if (!strcmp(optarg, "p")) t.arrivals = POISSON;
+                if (!strcmp(optarg, "b")) t.arrivals = BURSTY;
+                if (!strcmp(optarg, "d")) t.arrivals = DIURNAL;
+                break;
+
+            case 'r': t.rate = atof(optarg) > 0 ? atof(optarg) : t.rate; break;
+            case 'j': t.job = get_distribution(optarg); break;
+            case 'J': t.job_mean = max(atof(optarg), 1); break;
+            case 'm': t.mem = get_distribution(optarg); break;
+            case 'M': t.mem_mean = max(atof(optarg), 1); break;
+            case 'X': t.mem_max = max(atoi(optarg), PAGE_SIZE); break;
+            case 'P': t.period = max(atoi(optarg), 1); break;
+            case 'S': seed = strtoull(optarg, NULL, 10); break;
+            case 'D': t.parents = max(atoi(optarg), 0); break;
+            case 'I': t.io_mean = max(atof(optarg), 0); break;
+            case 'C': t.cpu_mean = max(atof(optarg), 1); break;
+        }
+    }
+
+    // Independent streams so changing one distribution leaves the others
+    t.arrival_rng = rng_seed(seed, 0);
+    t.job_rng = rng_seed(seed, 1);
+    t.mem_rng = rng_seed(seed, 2);
+    t.dag_rng = rng_seed(seed, 3);
+    t.burst_rng = rng_seed(seed, 4);
+
+    for (int i = 1; i <= n; i++) {
+
+        Time time = next_time(&t);
+
+        // Memory is a whole number of pages
+        mem = draw(t.mem, &t.mem_rng, t.mem_mean);
+        mem = (mem + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+        mem = min(mem, t.mem_max / PAGE_SIZE * PAGE_SIZE);
+
+        job = draw(t.job, &t.job_rng, t.job_mean);
+        printf("%lld %d %d %d", time, i, mem, job);
+
+        if (t.parents) print_parents(&t, i);
+        if (t.io_mean > 0) print_bursts(&t, job);
+        printf("\n");
+    }
+
+    return 0;
+}
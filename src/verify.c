@@ -0,0 +1,168 @@
+/*
+ * verify.c
+ *
+ * Replays a run against golden output recorded from an earlier run,
+ * checking that every event and statistic is unchanged and that the
+ * run has not slowed down. Written for project 2 of COMP30023
+ * Computer Systems, semester 1 2020.
+ *
+ * Author: Brodie Daff
+ *         bdaff@student.unimelb.edu.au
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "verify.h"
+
+/*
+ * Starts verifying or timing an OS, capturing its output from now on.
+ *
+ * System *sys:     Pointer to an OS struct.
+ * char *golden:    File holding the golden output, or NULL to only time.
+ * double baseline: CPU time in seconds of the golden run, or 0 if unknown.
+ * double load:     CPU time in seconds taken to load the processes.
+ */
+void verify_init(System *sys, char *golden, double baseline, double load) {
+
+    Verifier *v = (Verifier*)calloc(1, sizeof(Verifier));
+
+    v->golden = golden;
+    v->baseline = baseline;
+    v->load = load;
+
+    if ((sys->out = open_memstream(&v->output, &v->len)) == NULL) exit(EXIT_FAILURE);
+
+    sys->verifier = v;
+    v->start = clock();
+    v->cycles = profile_cycles();
+}
+
+/*
+ * Counts the cycles since the given cycle count as spent formatting
+ * output rather than simulating, if the OS is being timed. Cycles
+ * are counted as they are far cheaper to read around every event
+ * than the CPU time.
+ *
+ * System *sys:    Pointer to an OS struct.
+ * uint64_t start: Cycle count the output started being formatted at.
+ */
+void verify_output(System *sys, uint64_t start) {
+
+    if (sys->verifier != NULL) sys->verifier->formatting += profile_cycles() - start;
+}
+
+/*
+ * Compares captured output with the golden output line by line,
+ * reporting the first difference.
+ *
+ * Verifier *v: Pointer to a run being verified.
+ *
+ * Returns int: Number of lines compared, or UNDEF if they differ.
+ */
+static int compare_golden(Verifier *v) {
+
+    int n = 0;
+    char *line = NULL, *actual = v->output, *end;
+    size_t len = 0, length;
+    ssize_t read;
+    FILE *file;
+
+    if ((file = fopen(v->golden, "r")) == NULL) {
+        fprintf(stderr, "Cannot open golden output %s\n", v->golden);
+        return UNDEF;
+    }
+
+    while ((read = getline(&line, &len, file)) != -1) {
+
+        n++;
+
+        // Line of captured output, with its newline
+        end = strchr(actual, '\n');
+        length = end == NULL ? strlen(actual) : (size_t)(end - actual + 1);
+
+        if (length != (size_t)read || memcmp(line, actual, length)) {
+            fprintf(stderr, "Line %d differs\n  golden: %s", n, line);
+            fprintf(stderr, "  output: %.*s%s", (int)length, actual, end == NULL ? "\n" : "");
+            n = UNDEF;
+            break;
+        }
+
+        actual += length;
+    }
+
+    if (n != UNDEF && *actual) {
+        fprintf(stderr, "Line %d differs\n  golden: \n  output: %.*s", n + 1,
+                (int)(strcspn(actual, "\n") + 1), actual);
+        n = UNDEF;
+    }
+
+    free(line);
+    fclose(file);
+    return n;
+}
+
+/*
+ * Finishes verifying an OS, printing its captured output and
+ * reporting to stderr the first line that differs from the golden
+ * output, and the CPU time taken loading, simulating and printing
+ * against the baseline.
+ *
+ * System *sys: Pointer to an OS struct.
+ *
+ * Returns int: EXIT_SUCCESS if the output matched and the run was
+ *              not slower than the baseline, EXIT_FAILURE otherwise.
+ */
+int verify(System *sys) {
+
+    // Shorthand
+    Verifier *v = sys->verifier;
+
+    double simulation = (double)(clock() - v->start) / CLOCKS_PER_SEC, output, elapsed, share;
+    uint64_t cycles = profile_cycles() - v->cycles;
+    int n, result = EXIT_SUCCESS;
+
+    // Formatting events as they happen is output, not simulation
+    share = cycles ? (double)v->formatting / cycles : 0;
+    output = simulation * share;
+    simulation -= output;
+
+    fclose(sys->out);
+    sys->out = stdout;
+
+    v->start = clock();
+    fwrite(v->output, 1, v->len, stdout);
+    fflush(stdout);
+
+    output += (double)(clock() - v->start) / CLOCKS_PER_SEC;
+    elapsed = v->load + simulation + output;
+
+    if (v->golden != NULL) {
+        if ((n = compare_golden(v)) == UNDEF) {
+            result = EXIT_FAILURE;
+        } else {
+            fprintf(stderr, "Verified %d lines against %s\n", n, v->golden);
+        }
+    }
+
+    fprintf(stderr, "CPU time %.3f seconds (load %.3f, simulation %.3f, output %.3f)",
+            elapsed, v->load, simulation, output);
+
+    if (v->baseline > 0) {
+        fprintf(stderr, ", baseline %.3f (%+.0f%%)", v->baseline,
+                (elapsed / v->baseline - 1) * 100);
+
+        if (elapsed > v->baseline * VERIFY_TOLERANCE + VERIFY_SLACK) {
+            fprintf(stderr, ", slower than allowed");
+            result = EXIT_FAILURE;
+        }
+    }
+    fprintf(stderr, "\n");
+
+    free(v->output);
+    free(v);
+    sys->verifier = NULL;
+
+    return result;
+}